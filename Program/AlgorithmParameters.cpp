@@ -28,6 +28,18 @@ struct AlgorithmParameters default_algorithm_parameters() {
 	ap.mdmNURestarts = 0.05;
 	ap.mdmMinSup = 0.8;
 
+	ap.spatialOrdering = 0;
+	ap.nbThreads = 1;
+	ap.mdmBackgroundMining = 0;
+	ap.packedDistances = -1;
+	ap.lsCacheSize = 0;
+	ap.crossoverType = 0;
+
+	ap.decompositionMinClients = 2000;
+	ap.decompositionInterval = 1000;
+	ap.decompositionSize = 200;
+	ap.decompositionNbIter = 1000;
+
 	return ap;
 }
 
@@ -49,5 +61,15 @@ void print_algorithm_parameters(const AlgorithmParameters & ap)
 	std::cout << "---- mdmNbPatterns     is set to " << ap.mdmNbPatterns << std::endl;
 	std::cout << "---- mdmNURestarts     is set to " << ap.mdmNURestarts << std::endl;
 	std::cout << "---- mdmMinSup         is set to " << ap.mdmMinSup << std::endl;
+	std::cout << "---- spatialOrdering   is set to " << ap.spatialOrdering << std::endl;
+	std::cout << "---- nbThreads         is set to " << ap.nbThreads << std::endl;
+	std::cout << "---- mdmBackgroundMining is set to " << ap.mdmBackgroundMining << std::endl;
+	std::cout << "---- packedDistances   is set to " << ap.packedDistances << std::endl;
+	std::cout << "---- lsCacheSize       is set to " << ap.lsCacheSize << std::endl;
+	std::cout << "---- crossoverType     is set to " << ap.crossoverType << std::endl;
+	std::cout << "---- decompositionMinClients is set to " << ap.decompositionMinClients << std::endl;
+	std::cout << "---- decompositionInterval is set to " << ap.decompositionInterval << std::endl;
+	std::cout << "---- decompositionSize is set to " << ap.decompositionSize << std::endl;
+	std::cout << "---- decompositionNbIter is set to " << ap.decompositionNbIter << std::endl;
 	std::cout << "==================================================" << std::endl;
 }
@@ -17,7 +17,7 @@ struct AlgorithmParameters {
 
 	int seed;				// Random seed. Default value: 0
 	int nbIter;				// Nb iterations without improvement until termination (or restart if a time limit is specified). Default value: 20,000 iterations
-	double timeLimit;		// CPU time limit until termination in seconds. Default value: 0 (i.e., inactive)
+	double timeLimit;		// Time limit until termination in seconds (wall-clock time). Default value: 0 (i.e., inactive)
 	int useSwapStar;		// Use SWAP* local search or not. Default value: 1. Only available when coordinates are provided.
 	
 	double randGeneration;	// Portion of randomly generated individuals (the other part is generated using a randomized version of the Clarke & Wright savings heuristic). Default value: -1 (dynamic, based on instance size)
@@ -26,6 +26,19 @@ struct AlgorithmParameters {
 	int mdmNbPatterns;		// Number of (largest) patterns to be mined from the MDM elite set
 	double mdmNURestarts;	// Portion of restarts without update of the MDM elite set to trigger data mining (with respect to a dynamically estimated total)
 	double mdmMinSup;		// Minimum support for the MDM elite set mined patterns
+
+	// Fields added after the original ones, so that the layout of the original fields is kept for the callers mirroring this structure (FFI, hgs-server requests)
+	int spatialOrdering;	// Internal renumbering of the clients along a space-filling curve to improve memory locality: 0 (input order), 1 (Morton order) or 2 (Hilbert order). Default value: 0. Only available when coordinates are provided.
+	int nbThreads;			// Number of offspring generated at each iteration and improved in parallel by as many local search threads (also the number of subproblems of a decomposition phase solved in parallel). Default value: 1 (sequential search)
+	int mdmBackgroundMining;	// If set, mining runs in a background thread on a snapshot of the MDM elite set, and the patterns are used as soon as they are ready (the search is then no longer reproducible for a given seed)
+	int packedDistances;	// Storage of a symmetric distance matrix as a packed triangle (n(n+1)/2 values instead of n*n), which slows down the accesses: 0 (never), 1 (always) or -1 (dynamic, for instances of 5,000 nodes or more). Default value: -1. A matrix computed from coordinates is built in this layout, so that the peak memory is one packed matrix (two with a spatial ordering). A matrix given to the C interface is read in place, or copied once in this layout
+	int lsCacheSize;		// Maximum number of local search results memorized (for each local search structure), so that the solutions obtained several times are not improved again. Default value: 0 (inactive)
+	int crossoverType;		// Crossover operator: 0 (OX on the giant tours, completed by Split) or 1 (SREX, exchanging routes between the parents without Split). Default value: 0
+
+	int decompositionMinClients;	// Minimum number of clients for the decomposition phases, in which the routes of the best feasible solution are partitioned by polar angle and each group is improved as a subproblem. Default value: 2,000 (0: never). Only available when coordinates are provided.
+	int decompositionInterval;	// Number of iterations between two decomposition phases. Default value: 1,000
+	int decompositionSize;		// Target number of clients of a subproblem. Default value: 200
+	int decompositionNbIter;	// Nb iterations without improvement until termination of the search on a subproblem. Default value: 1,000
 };
 
 
@@ -7,15 +7,18 @@
 #include "Params.h"
 #include "Genetic.h"
 #include <string>
-#include <iostream>
 #include <vector>
 #include <cmath>
+#include <cstring>
+#include <new>
 
 Solution *prepare_solution(Population &population, Params &params)
 {
 	// Preparing the best solution
 	Solution *sol = new Solution;
-	sol->time = (double)(clock() - params.startTime) / (double)CLOCKS_PER_SEC;
+	sol->time = params.getElapsedTime();
+	sol->error_code = HGS_OK;
+	sol->error_message[0] = '\0';
 
 	if (population.getBestFound() != nullptr) {
 		// Best individual
@@ -35,7 +38,8 @@ Solution *prepare_solution(Population &population, Params &params)
 		for (int k = 0; k < n_routes; k++) {
 			sol->routes[k].length = (int)best->chromR[k].size();
 			sol->routes[k].path = new int[sol->routes[k].length];
-			std::copy(best->chromR[k].begin(), best->chromR[k].end(), sol->routes[k].path);
+			for (int i = 0; i < sol->routes[k].length; i++)
+				sol->routes[k].path[i] = params.originalIndex[best->chromR[k][i]]; // Clients are returned with their index in the input data
 		}
 	}
 	else {
@@ -46,57 +50,163 @@ Solution *prepare_solution(Population &population, Params &params)
 	return sol;
 }
 
+// Solution without routes reporting a failed solve (nullptr if even this allocation fails)
+Solution *error_solution(int errorCode, const std::string &message)
+{
+	Solution *sol = new (std::nothrow) Solution;
+	if (sol == nullptr) return nullptr;
+	sol->cost = 0.0;
+	sol->time = 0.0;
+	sol->n_routes = 0;
+	sol->routes = nullptr;
+	sol->error_code = errorCode;
+	std::strncpy(sol->error_message, message.c_str(), sizeof(sol->error_message) - 1);
+	sol->error_message[sizeof(sol->error_message) - 1] = '\0';
+	return sol;
+}
+
+// Checks the arrays and sizes common to all solve functions, throws the reason of the rejection otherwise
+void check_input(int n, const double *serv_time, const double *dem, const AlgorithmParameters *ap)
+{
+	if (n < 2) throw std::string("The data must contain the depot and at least one client");
+	if (serv_time == nullptr || dem == nullptr) throw std::string("The service times and the demands must be provided");
+	if (ap == nullptr) throw std::string("The algorithm parameters must be provided");
+}
+
+// Log sink of a solve: the lines go to the log callback of the options if there is one, to the standard output otherwise
+std::function <void(const std::string &)> log_sink(const SolveOptions *options)
+{
+	if (options == nullptr || options->log_callback == nullptr) return nullptr;
+	return [options](const std::string &line) { options->log_callback(line.c_str(), options->user_data); };
+}
+
+Solution *run_solver(Params &params, const SolveOptions *options)
+{
+	Genetic solver(params);
+
+	// View of the new best solutions passed to the callback: the routes point to the individual itself, unless the clients need to be renumbered
+	std::vector<SolutionRoute> viewRoutes;
+	std::vector<int> viewClients(params.nbClients);
+	bool isRenumbered = false;
+	for (int i = 0; i <= params.nbClients; i++)
+		if (params.originalIndex[i] != i) isRenumbered = true;
+	if (options != nullptr && options->new_best_callback != nullptr)
+		solver.population.newBestCallback = [&](const Individual &indiv)
+		{
+			viewRoutes.clear();
+			int nbClientsViewed = 0;
+			for (int k = 0; k < params.nbVehicles; k++)
+			{
+				if (indiv.chromR[k].empty()) continue;
+				SolutionRoute route;
+				route.length = (int)indiv.chromR[k].size();
+				if (isRenumbered)
+				{
+					route.path = &viewClients[nbClientsViewed];
+					for (int i = 0; i < route.length; i++) route.path[i] = params.originalIndex[indiv.chromR[k][i]];
+				}
+				else route.path = const_cast<int *>(indiv.chromR[k].data());
+				nbClientsViewed += route.length;
+				viewRoutes.push_back(route);
+			}
+
+			Solution view;
+			view.cost = indiv.eval.penalizedCost;
+			view.time = params.getElapsedTime();
+			view.n_routes = (int)viewRoutes.size();
+			view.routes = viewRoutes.data();
+			view.error_code = HGS_OK;
+			view.error_message[0] = '\0';
+			return options->new_best_callback(&view, options->user_data) != 0;
+		};
+
+	if (options != nullptr && options->stop_callback != nullptr)
+		solver.stopCallback = [options]() { return options->stop_callback(options->user_data) != 0; };
+
+	if (options != nullptr && options->n_initial_routes > 0)
+	{
+		std::vector<std::vector<int> > routes;
+		for (int r = 0; r < options->n_initial_routes; r++)
+			routes.emplace_back(options->initial_routes[r].path, options->initial_routes[r].path + options->initial_routes[r].length);
+		solver.population.addInitialSolution(routes, options->seed_mdm_elite);
+	}
+	solver.run();
+	if (options != nullptr && options->ls_stats != nullptr) *options->ls_stats = solver.getLocalSearchStats();
+	return prepare_solution(solver.population, params);
+}
+
+extern "C" SolveOptions default_solve_options()
+{
+	SolveOptions options;
+	options.n_initial_routes = 0;
+	options.initial_routes = nullptr;
+	options.seed_mdm_elite = 0;
+	options.new_best_callback = nullptr;
+	options.stop_callback = nullptr;
+	options.log_callback = nullptr;
+	options.user_data = nullptr;
+	options.ls_stats = nullptr;
+	return options;
+}
 
 extern "C" Solution *solve_cvrp(
 	int n, double *x, double *y, double *serv_time, double *dem,
 	double vehicleCapacity, double durationLimit, char isRoundingInteger, char isDurationConstraint,
 	int max_nbVeh, const AlgorithmParameters *ap, char verbose)
 {
-	Solution *result;
+	return solve_cvrp_with_options(n, x, y, serv_time, dem, vehicleCapacity, durationLimit, isRoundingInteger, isDurationConstraint, max_nbVeh, ap, nullptr, verbose);
+}
+
+extern "C" Solution *solve_cvrp_dist_mtx(
+	int n, double *x, double *y, double *dist_mtx, double *serv_time, double *dem,
+	double vehicleCapacity, double durationLimit, char isDurationConstraint,
+	int max_nbVeh, const AlgorithmParameters *ap, char verbose)
+{
+	return solve_cvrp_dist_mtx_with_options(n, x, y, dist_mtx, serv_time, dem, vehicleCapacity, durationLimit, isDurationConstraint, max_nbVeh, ap, nullptr, verbose);
+}
+
+extern "C" Solution *solve_cvrp_with_options(
+	int n, double *x, double *y, double *serv_time, double *dem,
+	double vehicleCapacity, double durationLimit, char isRoundingInteger, char isDurationConstraint,
+	int max_nbVeh, const AlgorithmParameters *ap, const SolveOptions *options, char verbose)
+{
+	Solution *result = nullptr;
 
 	try {
+		check_input(n, serv_time, dem, ap);
+		if (x == nullptr || y == nullptr) throw std::string("The coordinates must be provided");
 		std::vector<double> x_coords(x, x + n);
 		std::vector<double> y_coords(y, y + n);
 		std::vector<double> service_time(serv_time, serv_time + n);
 		std::vector<double> demands(dem, dem + n);
 
-		std::vector<std::vector<double> > distance_matrix(n, std::vector<double>(n));
-		for (int i = 0; i < n; i++)
-		{
-			for (int j = 0; j < n; j++)
-			{
-				distance_matrix[i][j] = std::sqrt(
-					(x_coords[i] - x_coords[j])*(x_coords[i] - x_coords[j])
-					+ (y_coords[i] - y_coords[j])*(y_coords[i] - y_coords[j])
-				);
-				if (isRoundingInteger)
-					distance_matrix[i][j] = std::round(distance_matrix[i][j]);
-			}
-		}
+		// The matrix is built in the storage layout of Params, which takes it over
+		DistanceMatrix distance_matrix = DistanceMatrix::buildEuclidean(x_coords, y_coords, isRoundingInteger, Params::isPackedStorage(n, true, *ap));
 
-		Params params(x_coords,y_coords,distance_matrix,service_time,demands,vehicleCapacity,durationLimit,max_nbVeh,isDurationConstraint,verbose,*ap);
+		Params params(x_coords,y_coords,std::move(distance_matrix),service_time,demands,vehicleCapacity,durationLimit,max_nbVeh,isDurationConstraint,verbose,*ap,log_sink(options));
 
 		// Running HGS and returning the result
-		Genetic solver(params);
-		solver.run();
-		result = prepare_solution(solver.population, params);
+		result = run_solver(params, options);
 	}
-	catch (const std::string &e) { std::cout << "EXCEPTION | " << e << std::endl; }
-	catch (const std::exception &e) { std::cout << "EXCEPTION | " << e.what() << std::endl; }
+	catch (const std::string &e) { result = error_solution(HGS_ERROR_INVALID_INPUT, e); }
+	catch (const std::bad_alloc &) { result = error_solution(HGS_ERROR_OUT_OF_MEMORY, "Out of memory"); }
+	catch (const std::exception &e) { result = error_solution(HGS_ERROR_INTERNAL, e.what()); }
 
 	return result;
 }
 
-extern "C" Solution *solve_cvrp_dist_mtx(
+extern "C" Solution *solve_cvrp_dist_mtx_with_options(
 	int n, double *x, double *y, double *dist_mtx, double *serv_time, double *dem,
 	double vehicleCapacity, double durationLimit, char isDurationConstraint,
-	int max_nbVeh, const AlgorithmParameters *ap, char verbose)
+	int max_nbVeh, const AlgorithmParameters *ap, const SolveOptions *options, char verbose)
 {
-	Solution *result;
+	Solution *result = nullptr;
 	std::vector<double> x_coords;
 	std::vector<double> y_coords;
 
 	try {
+		check_input(n, serv_time, dem, ap);
+		if (dist_mtx == nullptr) throw std::string("The distance matrix must be provided");
 		if (x != nullptr && y != nullptr) {
 			x_coords = {x, x + n};
 			y_coords = {y, y + n};
@@ -105,28 +215,24 @@ extern "C" Solution *solve_cvrp_dist_mtx(
 		std::vector<double> service_time(serv_time, serv_time + n);
 		std::vector<double> demands(dem, dem + n);
 
-		std::vector<std::vector<double> > distance_matrix(n, std::vector<double>(n));
-		for (int i = 0; i < n; i++) { // row
-			for (int j = 0; j < n; j++) { // column
-				distance_matrix[i][j] = dist_mtx[n * i + j];
-			}
-		}
+		// View on the row-major matrix of the caller, which outlives the search: Params reads it in place, or copies it in its own numbering and layout
+		DistanceMatrix distance_matrix(n, false, dist_mtx);
 
-		Params params(x_coords,y_coords,distance_matrix,service_time,demands,vehicleCapacity,durationLimit,max_nbVeh,isDurationConstraint,verbose,*ap);
+		Params params(x_coords,y_coords,std::move(distance_matrix),service_time,demands,vehicleCapacity,durationLimit,max_nbVeh,isDurationConstraint,verbose,*ap,log_sink(options));
 		
 		// Running HGS and returning the result
-		Genetic solver(params);
-		solver.run();
-		result = prepare_solution(solver.population, params);
+		result = run_solver(params, options);
 	}
-	catch (const std::string &e) { std::cout << "EXCEPTION | " << e << std::endl; }
-	catch (const std::exception &e) { std::cout << "EXCEPTION | " << e.what() << std::endl; }
+	catch (const std::string &e) { result = error_solution(HGS_ERROR_INVALID_INPUT, e); }
+	catch (const std::bad_alloc &) { result = error_solution(HGS_ERROR_OUT_OF_MEMORY, "Out of memory"); }
+	catch (const std::exception &e) { result = error_solution(HGS_ERROR_INTERNAL, e.what()); }
 
 	return result;
 }
 
 extern "C" void delete_solution(Solution *sol)
 {
+	if (sol == nullptr) return;
 	for (int i = 0; i < sol->n_routes; ++i)
 		delete[] sol->routes[i].path;
 
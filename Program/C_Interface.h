@@ -5,6 +5,7 @@
 #ifndef C_INTERFACE_H
 #define C_INTERFACE_H
 #include "AlgorithmParameters.h"
+#include "LocalSearchStats.h"
 
 struct SolutionRoute
 {
@@ -12,14 +13,43 @@ struct SolutionRoute
 	int * path;
 };
 
+// Error codes of a solve
+enum HgsErrorCode
+{
+	HGS_OK = 0,						// The search has been completed (or stopped by a callback)
+	HGS_ERROR_INVALID_INPUT = 1,	// The data or the parameters have been rejected (see error_message)
+	HGS_ERROR_OUT_OF_MEMORY = 2,	// A memory allocation failed
+	HGS_ERROR_INTERNAL = 3			// Unexpected error of the solver (see error_message)
+};
+
 struct Solution
 {
 	double cost;
 	double time;
 	int n_routes;
 	struct SolutionRoute * routes;
+	int error_code;					// HGS_OK, or the reason why the solve failed (the solution then has no routes)
+	char error_message[256];		// Description of the error (empty if error_code is HGS_OK)
+};
+
+// Additional options of a solve
+struct SolveOptions
+{
+	int n_initial_routes;							// Number of routes of an initial solution (0 if no initial solution is given)
+	const struct SolutionRoute * initial_routes;	// Routes of the initial solution, with the clients numbered as in the input data (depot excluded)
+	char seed_mdm_elite;							// If nonzero, the initial solution (after local search) is also inserted in the MDM elite set
+	int (*new_best_callback)(const struct Solution * sol, void * user_data);	// Called each time the best solution is improved (optional). The solution is only valid during the call. Returning a nonzero value stops the search
+	int (*stop_callback)(void * user_data);			// Polled at each iteration of the search (optional, may be used to cancel the search from another thread), and by the threads of the decomposition phases (one call at a time). Returning a nonzero value stops the search
+	void (*log_callback)(const char * line, void * user_data);	// Receives each line of the log of a verbose solve, in the thread of the solve (optional, the lines are written on the standard output otherwise)
+	void * user_data;								// Pointer passed back to new_best_callback, stop_callback and log_callback
+	struct LocalSearchStats * ls_stats;				// If not NULL, receives the counters of the local search operators at the end of the search (see isEnabled)
 };
 
+#ifdef __cplusplus
+extern "C"
+#endif
+struct SolveOptions default_solve_options();
+
 #ifdef __cplusplus
 extern "C"
 #endif
@@ -36,6 +66,22 @@ struct Solution *solve_cvrp_dist_mtx(
 	double vehicleCapacity, double durationLimit, char isDurationConstraint,
 	int max_nbVeh, const struct AlgorithmParameters *ap, char verbose);
 
+#ifdef __cplusplus
+extern "C"
+#endif
+struct Solution * solve_cvrp_with_options(
+	int n, double* x, double* y, double* serv_time, double* dem,
+	double vehicleCapacity, double durationLimit, char isRoundingInteger, char isDurationConstraint,
+	int max_nbVeh, const struct AlgorithmParameters* ap, const struct SolveOptions* options, char verbose);
+
+#ifdef __cplusplus
+extern "C"
+#endif
+struct Solution *solve_cvrp_dist_mtx_with_options(
+	int n, double* x, double* y, double *dist_mtx, double *serv_time, double *dem,
+	double vehicleCapacity, double durationLimit, char isDurationConstraint,
+	int max_nbVeh, const struct AlgorithmParameters *ap, const struct SolveOptions* options, char verbose);
+
 #ifdef __cplusplus
 extern "C"
 #endif
@@ -0,0 +1,74 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstdint>
+#include <type_traits>
+
+#define CHECKPOINT_VERSION 3
+
+// Serializes the search state in a compact binary buffer (native endianness, only meant to be read back by the same build)
+class CheckpointWriter
+{
+public:
+
+	std::string buffer;		// Serialized data
+
+	template <typename T> void write(const T & value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be written directly");
+		buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <typename T> void write(const std::vector <T> & values)
+	{
+		write((uint64_t)values.size());
+		for (const T & value : values) write(value);
+	}
+
+	void write(const std::string & value)
+	{
+		write((uint64_t)value.size());
+		buffer.append(value);
+	}
+};
+
+// Reads back the search state written by a CheckpointWriter
+class CheckpointReader
+{
+public:
+
+	std::istream & in;		// Input stream
+
+	template <typename T> void read(T & value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+		if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) throw std::string("Unexpected end of checkpoint file");
+	}
+
+	template <typename T> void read(std::vector <T> & values)
+	{
+		values.resize(readSize());
+		for (T & value : values) read(value);
+	}
+
+	void read(std::string & value)
+	{
+		value.resize(readSize());
+		if (!in.read(&value[0], (std::streamsize)value.size())) throw std::string("Unexpected end of checkpoint file");
+	}
+
+	uint64_t readSize()
+	{
+		uint64_t size;
+		read(size);
+		if (size > (uint64_t)1 << 32) throw std::string("Corrupted checkpoint file");
+		return size;
+	}
+
+	CheckpointReader(std::istream & in) : in(in) {}
+};
+
+#endif
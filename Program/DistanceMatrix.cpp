@@ -0,0 +1,88 @@
+#include "DistanceMatrix.h"
+
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <functional>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DISTANCE_MATRIX_SSE2
+#endif
+
+// Below this number of nodes, the matrix is computed by the calling thread only
+#define DISTANCE_MATRIX_MIN_PARALLEL_SIZE 2000
+
+// Size of the tiles used when mirroring the matrix
+#define DISTANCE_MATRIX_TILE_SIZE 64
+
+// Distances from point i to points 0 ... i-1, written in row (the part of row i of the matrix before its diagonal, in both layouts)
+static void computeRow(int i, const double * x, const double * y, bool isRoundingInteger, double * row)
+{
+	int j = 0;
+#ifdef DISTANCE_MATRIX_SSE2
+	const __m128d xi = _mm_set1_pd(x[i]);
+	const __m128d yi = _mm_set1_pd(y[i]);
+	const __m128d two52 = _mm_set1_pd(4503599627370496.); // 2^52: adding and subtracting it rounds a non-negative value to the nearest integer (ties to even)
+	const __m128d half = _mm_set1_pd(0.5);
+	const __m128d one = _mm_set1_pd(1.);
+	for (; j + 1 < i; j += 2)
+	{
+		__m128d dx = _mm_sub_pd(xi, _mm_loadu_pd(x + j));
+		__m128d dy = _mm_sub_pd(yi, _mm_loadu_pd(y + j));
+		__m128d d = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+		if (isRoundingInteger)
+		{
+			// std::round breaks ties away from zero: the ties rounded down to the even integer are corrected, and values above 2^52 are already integers
+			__m128d r = _mm_sub_pd(_mm_add_pd(d, two52), two52);
+			r = _mm_add_pd(r, _mm_and_pd(_mm_cmpeq_pd(_mm_sub_pd(d, r), half), one));
+			__m128d isLarge = _mm_cmpge_pd(d, two52);
+			d = _mm_or_pd(_mm_and_pd(isLarge, d), _mm_andnot_pd(isLarge, r));
+		}
+		_mm_storeu_pd(row + j, d);
+	}
+#endif
+	for (; j < i; j++)
+	{
+		row[j] = std::sqrt((x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]));
+		if (isRoundingInteger) row[j] = std::round(row[j]);
+	}
+}
+
+// Copies the lower triangle of a full matrix to its upper triangle for the rows of block b, one square tile at a time to limit the cache misses
+static void mirrorBlock(int b, int n, double * values)
+{
+	for (int jStart = 0; jStart <= b * DISTANCE_MATRIX_TILE_SIZE; jStart += DISTANCE_MATRIX_TILE_SIZE)
+		for (int i = b * DISTANCE_MATRIX_TILE_SIZE; i < std::min<int>((b + 1) * DISTANCE_MATRIX_TILE_SIZE, n); i++)
+			for (int j = jStart; j < std::min<int>(jStart + DISTANCE_MATRIX_TILE_SIZE, i); j++)
+				values[(std::size_t)j * n + i] = values[(std::size_t)i * n + j];
+}
+
+DistanceMatrix DistanceMatrix::buildEuclidean(const std::vector <double> & x_coords, const std::vector <double> & y_coords, bool isRoundingInteger, bool isPacked, int nbThreads)
+{
+	int n = (int)x_coords.size();
+	DistanceMatrix matrix(n, isPacked);
+	double * values = matrix.storage.data();
+	if (nbThreads <= 0) nbThreads = (int)std::thread::hardware_concurrency();
+	nbThreads = (n < DISTANCE_MATRIX_MIN_PARALLEL_SIZE) ? 1 : std::max<int>(1, std::min<int>(nbThreads, n / (DISTANCE_MATRIX_MIN_PARALLEL_SIZE / 2)));
+
+	// Runs tasks 0 ... nbTasks-1 over the threads. The rows are of unequal length, so the blocks of rows are picked dynamically
+	auto runParallel = [&](int nbTasks, const std::function<void(int)> & task)
+	{
+		std::atomic <int> nextTask(0);
+		auto work = [&]() { for (int t = nextTask++; t < nbTasks; t = nextTask++) task(t); };
+		std::vector <std::thread> threads;
+		for (int t = 1; t < nbThreads; t++) threads.emplace_back(work);
+		work();
+		for (std::thread & thread : threads) thread.join();
+	};
+	int nbBlocks = (n + DISTANCE_MATRIX_TILE_SIZE - 1) / DISTANCE_MATRIX_TILE_SIZE;
+	runParallel(nbBlocks, [&](int b)
+	{
+		for (int i = b * DISTANCE_MATRIX_TILE_SIZE; i < std::min<int>((b + 1) * DISTANCE_MATRIX_TILE_SIZE, n); i++)
+			computeRow(i, x_coords.data(), y_coords.data(), isRoundingInteger, values + matrix.index(i, 0));
+	});
+	if (!isPacked) runParallel(nbBlocks, [&](int b) { mirrorBlock(b, n, values); });
+	return matrix;
+}
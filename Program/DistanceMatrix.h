@@ -0,0 +1,86 @@
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <vector>
+#include <cstddef>
+
+// Square distance matrix stored contiguously, either in its own storage or as a view on external memory (e.g., a memory-mapped instance cache)
+// A symmetric matrix can be stored as its lower triangle (diagonal included) packed row by row, which halves its memory. Otherwise, the matrix is stored in full (row-major)
+class DistanceMatrix
+{
+	std::vector <double> storage;	// Own storage (empty for a view)
+	const double * data;			// First element of the matrix
+	int size;						// Number of rows and columns
+	bool packed;					// Whether only the lower triangle is stored
+
+	// Position of element (i,j) in the data. In a packed matrix, (i,j) is read from the lower triangle (the min/max compile to conditional moves)
+	inline std::size_t index(int i, int j) const
+	{
+		if (!packed) return (std::size_t)i * size + j;
+		std::size_t high = (std::size_t)(i > j ? i : j);
+		std::size_t low = (std::size_t)(i > j ? j : i);
+		return high * (high + 1) / 2 + low;
+	}
+
+public:
+
+	// Row i of the matrix, so that the distance between i and j is accessed as matrix[i][j]
+	class Row
+	{
+		const DistanceMatrix & matrix;
+		int i;
+	public:
+		Row(const DistanceMatrix & matrix, int i) : matrix(matrix), i(i) {}
+		inline double operator[](int j) const { return matrix.data[matrix.index(i, j)]; }
+	};
+
+	inline Row operator[](int i) const { return Row(*this, i); }
+
+	// Sets element (i,j) of a matrix owning its storage (for a packed matrix, this also sets (j,i))
+	inline void set(int i, int j, double value) { storage[index(i, j)] = value; }
+
+	// Number of rows and columns
+	inline int nbNodes() const { return size; }
+
+	// Whether the matrix is stored as a packed triangle
+	inline bool isPacked() const { return packed; }
+
+	// Number of values stored, and contiguous data of the matrix
+	inline std::size_t nbValues() const { return packed ? (std::size_t)size * (size + 1) / 2 : (std::size_t)size * size; }
+	inline const double * begin() const { return data; }
+
+	DistanceMatrix() : data(nullptr), size(0), packed(false) {}
+
+	// Matrix with its own storage, initialized to zero
+	DistanceMatrix(int size, bool isPacked) : data(nullptr), size(size), packed(isPacked)
+	{
+		storage = std::vector <double>(nbValues(), 0.);
+		data = storage.data();
+	}
+
+	// View on an external matrix stored in the same layout, which must outlive this object
+	DistanceMatrix(int size, bool isPacked, const double * externalData) : data(externalData), size(size), packed(isPacked) {}
+
+	DistanceMatrix(DistanceMatrix && other) noexcept : storage(std::move(other.storage)), data(other.data), size(other.size), packed(other.packed) { other.data = nullptr; other.size = 0; }
+
+	DistanceMatrix & operator=(DistanceMatrix && other) noexcept
+	{
+		storage = std::move(other.storage);
+		data = other.data;
+		size = other.size;
+		packed = other.packed;
+		other.data = nullptr;
+		other.size = 0;
+		return *this;
+	}
+
+	// Euclidean distance matrix of a set of points, optionally rounded to the nearest integer, built directly in the given layout (no intermediate full matrix)
+	// Only the lower triangle is computed (vectorized along the rows and split over threads), then mirrored in a full matrix. The values are bit-identical to std::sqrt and std::round
+	// Large matrices are split over nbThreads threads (the number of hardware threads if 0)
+	static DistanceMatrix buildEuclidean(const std::vector <double> & x_coords, const std::vector <double> & y_coords, bool isRoundingInteger, bool isPacked, int nbThreads = 0);
+
+	DistanceMatrix(const DistanceMatrix &) = delete;
+	DistanceMatrix & operator=(const DistanceMatrix &) = delete;
+};
+
+#endif
@@ -3,24 +3,68 @@
 void Genetic::run()
 {	
 	/* INITIAL POPULATION */
-	population.generatePopulation();
+	if (!isResumed)
+	{
+		population.generatePopulation();
+		nbIter = 0;
+		nbIterNonProd = 1;
+		nbRestarts = 0;
+		lastDecompositionIter = 0;
+	}
+	double lastCheckpointTime = params.getElapsedTime();
+
+	// The decomposition partitions the routes by polar angle, so it needs the coordinates (only kept by Params when SWAP* is used)
+	bool isDecompositionActive = (params.ap.decompositionMinClients > 0 && params.nbClients >= params.ap.decompositionMinClients && params.areCoordinatesProvided && params.ap.useSwapStar == 1);
+	if (!telemetryPath.empty())
+	{
+		telemetry.reset(new Telemetry(telemetryPath));
+		localSearch.isRunTimeMeasured = true;
+		for (std::unique_ptr <OffspringWorker> & worker : workers) worker->localSearch.isRunTimeMeasured = true;
+		lastTelemetryTime = params.getElapsedTime();
+		lastTelemetryIter = nbIter;
+		lastTelemetryLSTime = 0.;
+		recordTelemetry(TelemetryRecord::STATE);
+	}
 
-	int nbIter;
-	int nbIterNonProd = 1;
-	int nbRestarts = 0;
-	if (params.verbose) std::cout << "----- STARTING GENETIC ALGORITHM" << std::endl;
-	for (nbIter = 0 ; nbIterNonProd <= params.ap.nbIter && (params.ap.timeLimit == 0 || (double)(clock()-params.startTime)/(double)CLOCKS_PER_SEC < params.ap.timeLimit) ; nbIter++)
+	if (params.verbose) params.log("----- STARTING GENETIC ALGORITHM");
+	for ( ; nbIterNonProd <= params.ap.nbIter && (params.ap.timeLimit == 0 || params.getElapsedTime() < params.ap.timeLimit) && !population.isStopRequested ; nbIter++)
 	{	
-		/* SELECTION AND CROSSOVER */
-		crossoverOX(offspring, population.getBinaryTournament(),population.getBinaryTournament());
+		if (stopCallback && stopCallback())
+		{
+			population.isStopRequested = true;
+			break;
+		}
 
-		/* LOCAL SEARCH */
-		localSearch.run(offspring, params.penaltyCapacity, params.penaltyDuration);
-		bool isNewBest = population.addIndividual(offspring,true);
-		if (!offspring.eval.isFeasible && params.ran()%2 == 0) // Repair half of the solutions in case of infeasibility
+		/* CHECKPOINT OF THE SEARCH STATE (BETWEEN TWO BATCHES WHEN OFFSPRING ARE GENERATED IN PARALLEL) */
+		if (!checkpointPath.empty() && nextOffspring == (int)workers.size() && params.getElapsedTime() - lastCheckpointTime >= checkpointInterval)
 		{
-			localSearch.run(offspring, params.penaltyCapacity*10., params.penaltyDuration*10.);
-			if (offspring.eval.isFeasible) isNewBest = (population.addIndividual(offspring,false) || isNewBest);
+			writeCheckpoint(checkpointPath);
+			lastCheckpointTime = params.getElapsedTime();
+		}
+
+		bool isNewBest;
+		if (workers.empty())
+		{
+			/* SELECTION AND CROSSOVER */
+			crossover(offspring, population.getBinaryTournament(),population.getBinaryTournament(), split, params.ran);
+
+			/* LOCAL SEARCH */
+			localSearch.run(offspring, params.penaltyCapacity, params.penaltyDuration);
+			isNewBest = population.addIndividual(offspring,true);
+			if (!offspring.eval.isFeasible && params.ran()%2 == 0) // Repair half of the solutions in case of infeasibility
+			{
+				localSearch.run(offspring, params.penaltyCapacity*10., params.penaltyDuration*10.);
+				if (offspring.eval.isFeasible) isNewBest = (population.addIndividual(offspring,false) || isNewBest);
+			}
+		}
+		else // Offspring generated by batches in parallel, and inserted one at a time
+			isNewBest = addNextOffspring();
+
+		/* DECOMPOSITION OF LARGE INSTANCES (BETWEEN TWO BATCHES WHEN OFFSPRING ARE GENERATED IN PARALLEL) */
+		if (isDecompositionActive && nextOffspring == (int)workers.size() && nbIter - lastDecompositionIter >= params.ap.decompositionInterval)
+		{
+			isNewBest = (decompose() || isNewBest);
+			lastDecompositionIter = nbIter;
 		}
 
 		/* TRACKING THE NUMBER OF ITERATIONS SINCE LAST SOLUTION IMPROVEMENT */
@@ -30,34 +74,49 @@ void Genetic::run()
 		/* DIVERSIFICATION, PENALTY MANAGEMENT AND TRACES */
 		if (nbIter % 100 == 0) population.managePenalties() ;
 		if (nbIter % 500 == 0) population.printState(nbIter, nbIterNonProd);
+		if (telemetry && params.getElapsedTime() - lastTelemetryTime >= telemetryInterval) recordTelemetry(TelemetryRecord::STATE);
 
 		/* FOR TESTS INVOLVING SUCCESSIVE RUNS UNTIL A TIME LIMIT: WE RESET THE ALGORITHM/POPULATION EACH TIME maxIterNonProd IS ATTAINED*/
 		if (params.ap.timeLimit != 0 && nbIterNonProd == params.ap.nbIter)
 		{
 			nbRestarts++;
-			double elapsedTime = (double)(clock()-params.startTime)/(double)CLOCKS_PER_SEC;
+			double elapsedTime = params.getElapsedTime();
 			int estimatedRestarts = std::min((int) (params.ap.timeLimit / (elapsedTime / nbRestarts)), 1000);
 			population.mdmEliteMaxNonUpdatingRestarts = (int) (params.ap.mdmNURestarts * estimatedRestarts);
-			population.mineElite();
+			if (population.mineElite() && telemetry) recordTelemetry(TelemetryRecord::MINING);
+			if (telemetry) recordTelemetry(TelemetryRecord::RESTART);
 			population.restart();
+			nextOffspring = (int)workers.size(); // The remaining offspring of the current batch are discarded
 			nbIterNonProd = 1;
 		}
 	}
-	if (params.verbose) std::cout << "----- GENETIC ALGORITHM FINISHED AFTER " << nbIter << " ITERATIONS. TIME SPENT: " << (double)(clock() - params.startTime) / (double)CLOCKS_PER_SEC << std::endl;
+	if (checkpointWriting.valid()) checkpointWriting.get();
+	if (telemetry)
+	{
+		recordTelemetry(TelemetryRecord::STATE);
+		telemetry.reset(); // Waits for the remaining records to be written
+	}
+	if (params.verbose) params.log("----- GENETIC ALGORITHM FINISHED AFTER ", nbIter, " ITERATIONS. TIME SPENT: ", params.getElapsedTime());
+}
+
+void Genetic::crossover(Individual & result, const Individual & parent1, const Individual & parent2, Split & split, std::minstd_rand & ran)
+{
+	if (params.ap.crossoverType == 1) crossoverSREX(result, parent1, parent2, ran);
+	else crossoverOX(result, parent1, parent2, split, ran);
 }
 
-void Genetic::crossoverOX(Individual & result, const Individual & parent1, const Individual & parent2)
+void Genetic::crossoverOX(Individual & result, const Individual & parent1, const Individual & parent2, Split & split, std::minstd_rand & ran)
 {
 	// Frequency table to track the customers which have been already inserted
 	std::vector <bool> freqClient = std::vector <bool> (params.nbClients + 1, false);
 
 	// Picking the beginning and end of the crossover zone
 	std::uniform_int_distribution<> distr(0, params.nbClients-1);
-	int start = distr(params.ran);
-	int end = distr(params.ran);
+	int start = distr(ran);
+	int end = distr(ran);
 
 	// Avoid that start and end coincide by accident
-	while (end == start) end = distr(params.ran);
+	while (end == start) end = distr(ran);
 
 	// Copy from start to end
 	int j = start;
@@ -83,10 +142,517 @@ void Genetic::crossoverOX(Individual & result, const Individual & parent1, const
 	split.generalSplit(result, parent1.eval.nbRoutes);
 }
 
+void Genetic::crossoverSREX(Individual & result, const Individual & parent1, const Individual & parent2, std::minstd_rand & ran)
+{
+	// Non-empty routes of the parents (ordered by polar angle after the local search, so that consecutive routes are close to each other)
+	std::vector <int> routes1, routes2;
+	for (int r = 0; r < params.nbVehicles; r++)
+	{
+		if (!parent1.chromR[r].empty()) routes1.push_back(r);
+		if (!parent2.chromR[r].empty()) routes2.push_back(r);
+	}
+	int nbRoutes1 = (int)routes1.size();
+	int nbRoutes2 = (int)routes2.size();
+
+	// Picking the consecutive routes of the first parent to be replaced
+	int nbMoved = std::uniform_int_distribution<>(1, std::min<int>(nbRoutes1, nbRoutes2))(ran);
+	int start1 = std::uniform_int_distribution<>(0, nbRoutes1 - 1)(ran);
+	std::vector <bool> isMoved1(params.nbClients + 1, false);
+	for (int k = 0; k < nbMoved; k++)
+		for (int c : parent1.chromR[routes1[(start1 + k) % nbRoutes1]]) isMoved1[c] = true;
+
+	// Picking the consecutive routes of the second parent which serve the largest number of these clients
+	std::vector <int> overlap(nbRoutes2, 0);
+	for (int k = 0; k < nbRoutes2; k++)
+		for (int c : parent2.chromR[routes2[k]]) if (isMoved1[c]) overlap[k]++;
+	int windowOverlap = 0;
+	for (int k = 0; k < nbMoved; k++) windowOverlap += overlap[k];
+	int start2 = 0;
+	int bestOverlap = windowOverlap;
+	for (int k = 1; k < nbRoutes2; k++)
+	{
+		windowOverlap += overlap[(k + nbMoved - 1) % nbRoutes2] - overlap[k - 1];
+		if (windowOverlap > bestOverlap) { bestOverlap = windowOverlap; start2 = k; }
+	}
+	std::vector <bool> isMoved2(params.nbClients + 1, false);
+	for (int k = 0; k < nbMoved; k++)
+		for (int c : parent2.chromR[routes2[(start2 + k) % nbRoutes2]]) isMoved2[c] = true;
+
+	// Routes of the offspring: the other routes of the first parent (without the clients of the inserted routes), and the inserted routes of the second parent
+	std::vector < std::vector <int> > routes;
+	for (int k = nbMoved; k < nbRoutes1; k++)
+	{
+		routes.push_back(std::vector <int>());
+		for (int c : parent1.chromR[routes1[(start1 + k) % nbRoutes1]]) if (!isMoved2[c]) routes.back().push_back(c);
+		if (routes.back().empty()) routes.pop_back();
+	}
+	for (int k = 0; k < nbMoved; k++) routes.push_back(parent2.chromR[routes2[(start2 + k) % nbRoutes2]]);
+
+	std::vector <double> load(routes.size(), 0.);
+	std::vector <double> duration(routes.size(), 0.);
+	for (int r = 0; r < (int)routes.size(); r++)
+	{
+		int previous = 0;
+		for (int c : routes[r])
+		{
+			load[r] += params.cli[c].demand;
+			duration[r] += params.timeCost[previous][c] + params.cli[c].serviceDuration;
+			previous = c;
+		}
+		duration[r] += params.timeCost[previous][0];
+	}
+
+	// Inserting the missing clients (in the order of the first parent) at their cheapest positions, with the current penalties for excess load and duration
+	auto penalizedExcess = [&](double routeLoad, double routeDuration)
+	{
+		double penalty = params.penaltyCapacity * std::max<double>(0., routeLoad - params.vehicleCapacity);
+		if (params.isDurationConstraint) penalty += params.penaltyDuration * std::max<double>(0., routeDuration - params.durationLimit);
+		return penalty;
+	};
+	for (int k = 0; k < nbMoved; k++)
+		for (int c : parent1.chromR[routes1[(start1 + k) % nbRoutes1]])
+		{
+			if (isMoved2[c]) continue;
+			int bestRoute = -1;
+			int bestPosition = 0;
+			double bestCost = 1.e30;
+			double bestDeltaDuration = 0.;
+			for (int r = 0; r < (int)routes.size(); r++)
+			{
+				double currentPenalty = penalizedExcess(load[r], duration[r]);
+				for (int pos = 0; pos <= (int)routes[r].size(); pos++)
+				{
+					int previous = (pos == 0) ? 0 : routes[r][pos - 1];
+					int next = (pos == (int)routes[r].size()) ? 0 : routes[r][pos];
+					double deltaDuration = params.timeCost[previous][c] + params.timeCost[c][next] - params.timeCost[previous][next] + params.cli[c].serviceDuration;
+					double cost = deltaDuration - params.cli[c].serviceDuration + penalizedExcess(load[r] + params.cli[c].demand, duration[r] + deltaDuration) - currentPenalty;
+					if (cost < bestCost) { bestCost = cost; bestRoute = r; bestPosition = pos; bestDeltaDuration = deltaDuration; }
+				}
+			}
+			if ((int)routes.size() < params.nbVehicles) // Opening a new route
+			{
+				double newDuration = params.timeCost[0][c] + params.timeCost[c][0] + params.cli[c].serviceDuration;
+				if (newDuration - params.cli[c].serviceDuration + penalizedExcess(params.cli[c].demand, newDuration) < bestCost)
+				{
+					routes.push_back(std::vector <int>());
+					load.push_back(0.);
+					duration.push_back(0.);
+					bestRoute = (int)routes.size() - 1;
+					bestPosition = 0;
+					bestDeltaDuration = newDuration;
+				}
+			}
+			routes[bestRoute].insert(routes[bestRoute].begin() + bestPosition, c);
+			load[bestRoute] += params.cli[c].demand;
+			duration[bestRoute] += bestDeltaDuration;
+		}
+
+	// Complete individual, with its giant tour given by the succession of its routes
+	int pos = 0;
+	for (int r = 0; r < params.nbVehicles; r++)
+	{
+		if (r < (int)routes.size()) result.chromR[r] = routes[r];
+		else result.chromR[r].clear();
+		for (int c : result.chromR[r]) result.chromT[pos++] = c;
+	}
+	result.evaluateCompleteCost(params);
+}
+
+bool Genetic::addNextOffspring()
+{
+	if (nextOffspring == (int)workers.size()) generateBatch();
+	OffspringWorker & worker = *workers[nextOffspring++];
+
+	// Same insertion sequence as in the sequential algorithm
+	bool isNewBest = population.addIndividual(worker.offspring, true);
+	if (worker.hasRepair && worker.repairedOffspring.eval.isFeasible)
+		isNewBest = (population.addIndividual(worker.repairedOffspring, false) || isNewBest);
+	return isNewBest;
+}
+
+void Genetic::recordTelemetry(TelemetryRecord::Event event)
+{
+	TelemetryRecord record = {};
+	record.event = event;
+	record.time = params.getElapsedTime();
+	record.nbIter = nbIter;
+	record.nbRestarts = nbRestarts;
+	if (event == TelemetryRecord::STATE)
+	{
+		// The worker threads are idle outside generateBatch, so their local search times can be read here
+		double lsTime = localSearch.runTime;
+		for (std::unique_ptr <OffspringWorker> & worker : workers) lsTime += worker->localSearch.runTime;
+		double interval = record.time - lastTelemetryTime;
+		record.itersPerSecond = (interval > 0.) ? (nbIter - lastTelemetryIter) / interval : 0.;
+		record.lsTimeShare = (interval > 0.) ? (lsTime - lastTelemetryLSTime) / (interval * std::max<int>(1, (int)workers.size())) : 0.;
+		population.recordState(record);
+		lastTelemetryTime = record.time;
+		lastTelemetryIter = nbIter;
+		lastTelemetryLSTime = lsTime;
+	}
+	else record.mdmEliteSize = population.mdmEliteSize();
+	telemetry->record(record);
+}
+
+bool Genetic::decompose()
+{
+	const Individual * incumbent = population.getBestFeasible();
+	if (incumbent == NULL) return false;
+	TraceSpan span(params.trace.get(), "decompose");
+
+	// Groups of consecutive routes in the order of the polar angles of their barycenters, starting from a random route so that the boundaries change from one phase to the next
+	std::vector <int> routeOrder = localSearch.routesByPolarAngle(*incumbent);
+	int nbRoutes = (int)routeOrder.size();
+	int start = (int)(params.ran() % nbRoutes);
+	std::vector <DecompositionSubproblem> subproblems(1);
+	int nbGroupClients = 0;
+	for (int k = 0; k < nbRoutes; k++)
+	{
+		if (nbGroupClients >= params.ap.decompositionSize)
+		{
+			subproblems.emplace_back();
+			nbGroupClients = 0;
+		}
+		int r = routeOrder[(start + k) % nbRoutes];
+		subproblems.back().routeIndices.push_back(r);
+		nbGroupClients += (int)incumbent->chromR[r].size();
+	}
+	if (subproblems.size() > 1 && 2 * nbGroupClients < params.ap.decompositionSize) // The last group is merged with the previous one if it is too small
+	{
+		std::vector <int> & previous = subproblems[subproblems.size() - 2].routeIndices;
+		previous.insert(previous.end(), subproblems.back().routeIndices.begin(), subproblems.back().routeIndices.end());
+		subproblems.pop_back();
+	}
+	if (subproblems.size() < 2) return false;
+
+	// Each subproblem gets the vehicles of its routes and an equal share of the unused vehicles, so that the reassembled solution respects the fleet size
+	// The seeds are drawn by the main thread, so that the phase does not depend on thread scheduling
+	int nbSpareVehicles = std::max<int>(0, params.nbVehicles - nbRoutes) / (int)subproblems.size();
+	for (DecompositionSubproblem & subproblem : subproblems) subproblem.seed = params.ran();
+
+	// The searches on the subproblems stop with the complete search: time limit, or stop callback (polled by one subproblem at a time)
+	std::mutex stopCallbackMutex;
+	std::atomic <bool> isStopped(population.isStopRequested);
+	std::function <bool()> isSubproblemStopped = [&]()
+	{
+		if (isStopped || (params.ap.timeLimit != 0 && params.getElapsedTime() >= params.ap.timeLimit)) return true;
+		if (stopCallback)
+		{
+			std::lock_guard <std::mutex> lock(stopCallbackMutex);
+			if (!isStopped && stopCallback()) isStopped = true;
+		}
+		return isStopped.load();
+	};
+
+	// The subproblems are solved on as many threads as the offspring of a batch
+	int nbThreads = std::min<int>((int)subproblems.size(), std::max<int>(1, params.ap.nbThreads));
+	std::atomic <int> nextSubproblem(0);
+	auto solveSubproblems = [&]()
+	{
+		for (int g = nextSubproblem++; g < (int)subproblems.size(); g = nextSubproblem++)
+			solveSubproblem(subproblems[g], *incumbent, (int)subproblems[g].routeIndices.size() + nbSpareVehicles, isSubproblemStopped);
+	};
+	std::vector <std::thread> subproblemThreads;
+	for (int t = 1; t < nbThreads; t++) subproblemThreads.emplace_back(solveSubproblems);
+	solveSubproblems();
+	for (std::thread & thread : subproblemThreads) thread.join();
+	if (isStopped) population.isStopRequested = true;
+	for (DecompositionSubproblem & subproblem : subproblems)
+	{
+		if (subproblem.exception) std::rethrow_exception(subproblem.exception);
+		if (params.verbose && !subproblem.error.empty()) params.log("----- SUBPROBLEM OF THE DECOMPOSITION NOT SOLVED (ITS ROUTES ARE KEPT): ", subproblem.error);
+	}
+
+	// Reassembled solution, improved by the local search on the complete problem (in particular across the boundaries of the groups)
+	std::vector < std::vector <int> > routes;
+	for (DecompositionSubproblem & subproblem : subproblems) routes.insert(routes.end(), subproblem.routes.begin(), subproblem.routes.end());
+	Individual indiv(params, routes);
+	double incumbentCost = incumbent->eval.penalizedCost;
+	if (indiv.eval.penalizedCost > incumbentCost - MY_EPSILON) return false; // No subproblem has been improved
+	localSearch.run(indiv, params.penaltyCapacity, params.penaltyDuration);
+	bool isNewBest = population.addIndividual(indiv, true);
+	if (!indiv.eval.isFeasible)
+	{
+		localSearch.run(indiv, params.penaltyCapacity*10., params.penaltyDuration*10.);
+		if (indiv.eval.isFeasible) isNewBest = (population.addIndividual(indiv, false) || isNewBest);
+	}
+	if (params.verbose)
+		params.log("----- DECOMPOSITION IN ", subproblems.size(), " SUBPROBLEMS | COST ", incumbentCost, " -> ", indiv.eval.penalizedCost, " | T(s) ", params.getElapsedTime());
+	return isNewBest;
+}
+
+void Genetic::solveSubproblem(DecompositionSubproblem & subproblem, const Individual & incumbent, int nbVehicles, const std::function <bool()> & isStopped)
+{
+	subproblem.error.clear();
+	try
+	{
+		// Nodes of the subproblem: the depot, then the clients in the order of the routes
+		std::vector <int> nodes = { 0 };
+		std::vector < std::vector <int> > initialRoutes;
+		double initialCost = 0.;
+		for (int r : subproblem.routeIndices)
+		{
+			initialRoutes.push_back(std::vector <int>());
+			int previous = 0;
+			for (int c : incumbent.chromR[r])
+			{
+				initialRoutes.back().push_back((int)nodes.size());
+				nodes.push_back(c);
+				initialCost += params.timeCost[previous][c];
+				previous = c;
+			}
+			initialCost += params.timeCost[previous][0];
+		}
+		subproblem.routes.clear();
+		for (int r : subproblem.routeIndices) subproblem.routes.push_back(incumbent.chromR[r]);
+
+		// The distances are copied from the complete problem, so that both problems use the same rounding
+		int nbNodes = (int)nodes.size();
+		std::vector <double> x_coords(nbNodes), y_coords(nbNodes), service_time(nbNodes), demands(nbNodes);
+		std::vector < std::vector <double> > dist_mtx(nbNodes, std::vector <double>(nbNodes));
+		for (int i = 0; i < nbNodes; i++)
+		{
+			x_coords[i] = params.cli[nodes[i]].coordX;
+			y_coords[i] = params.cli[nodes[i]].coordY;
+			service_time[i] = params.cli[nodes[i]].serviceDuration;
+			demands[i] = params.cli[nodes[i]].demand;
+			for (int j = 0; j < nbNodes; j++) dist_mtx[i][j] = params.timeCost[nodes[i]][nodes[j]];
+		}
+
+		// Same parameters as the complete problem, with a sequential search of decompositionNbIter iterations without improvement
+		AlgorithmParameters ap = params.ap;
+		ap.seed = subproblem.seed;
+		ap.nbIter = params.ap.decompositionNbIter;
+		ap.timeLimit = 0;
+		ap.nbThreads = 1;
+		ap.decompositionMinClients = 0;
+		Params subParams(x_coords, y_coords, dist_mtx, service_time, demands, params.vehicleCapacity, params.durationLimit, nbVehicles, params.isDurationConstraint, false, ap);
+		Genetic solver(subParams);
+		solver.stopCallback = isStopped;
+		solver.population.addInitialSolution(initialRoutes, true);
+		solver.run();
+
+		const Individual * best = solver.population.getBestFound();
+		if (best != NULL && best->eval.penalizedCost < initialCost - MY_EPSILON)
+		{
+			subproblem.routes.clear();
+			for (const std::vector <int> & route : best->chromR)
+			{
+				if (route.empty()) continue;
+				subproblem.routes.push_back(std::vector <int>());
+				for (int c : route) subproblem.routes.back().push_back(nodes[subParams.originalIndex[c]]);
+			}
+		}
+		subproblem.exception = nullptr;
+	}
+	catch (const std::string & e) // Subproblem rejected by Params (e.g., scale of the data) or failed search: its routes are kept, and the error is logged by the main thread
+	{
+		subproblem.exception = nullptr;
+		subproblem.error = e;
+	}
+	catch (...) { subproblem.exception = std::current_exception(); }
+}
+
+void Genetic::generateBatch()
+{
+	// The main thread selects all parents and draws the seeds, so that the batch does not depend on thread scheduling
+	for (std::unique_ptr <OffspringWorker> & worker : workers)
+	{
+		worker->parent1 = &population.getBinaryTournament();
+		worker->parent2 = &population.getBinaryTournament();
+		worker->seed = params.ran();
+	}
+
+	{
+		std::lock_guard <std::mutex> lock(batchMutex);
+		batchID++;
+		nbWorkersRunning = (int)threads.size();
+	}
+	batchStarted.notify_all();
+
+	generateOffspring(*workers[0]);
+	std::unique_lock <std::mutex> lock(batchMutex);
+	batchFinished.wait(lock, [&] { return nbWorkersRunning == 0; });
+
+	for (std::unique_ptr <OffspringWorker> & worker : workers)
+		if (worker->exception) std::rethrow_exception(worker->exception);
+	nextOffspring = 0;
+}
+
+void Genetic::generateOffspring(OffspringWorker & worker)
+{
+	try
+	{
+		worker.ran.seed(worker.seed);
+		crossover(worker.offspring, *worker.parent1, *worker.parent2, worker.split, worker.ran);
+		worker.localSearch.run(worker.offspring, params.penaltyCapacity, params.penaltyDuration);
+		worker.hasRepair = (!worker.offspring.eval.isFeasible && worker.ran() % 2 == 0); // Repair half of the solutions in case of infeasibility
+		if (worker.hasRepair)
+		{
+			worker.repairedOffspring = worker.offspring;
+			worker.localSearch.run(worker.repairedOffspring, params.penaltyCapacity*10., params.penaltyDuration*10.);
+		}
+		worker.exception = nullptr;
+	}
+	catch (...) { worker.exception = std::current_exception(); }
+}
+
+void Genetic::workerLoop(OffspringWorker & worker)
+{
+	int lastBatchID = 0;
+	while (true)
+	{
+		{
+			std::unique_lock <std::mutex> lock(batchMutex);
+			batchStarted.wait(lock, [&] { return stopWorkers || batchID != lastBatchID; });
+			if (stopWorkers) return;
+			lastBatchID = batchID;
+		}
+		generateOffspring(worker);
+		{
+			std::lock_guard <std::mutex> lock(batchMutex);
+			nbWorkersRunning--;
+		}
+		batchFinished.notify_one();
+	}
+}
+
+void Genetic::writeCheckpoint(std::string fileName)
+{
+	CheckpointWriter writer;
+	writer.write(std::string("MDM-HGS-CVRP CHECKPOINT"));
+	writer.write((int)CHECKPOINT_VERSION);
+	writer.write(params.nbClients);
+	writer.write(params.nbVehicles);
+	writer.write(params.vehicleCapacity);
+	writer.write((int)workers.size());
+
+	writer.write(nbIter);
+	writer.write(nbIterNonProd);
+	writer.write(nbRestarts);
+	writer.write(lastDecompositionIter);
+	writer.write(params.getElapsedTime());
+	std::ostringstream ranState;
+	ranState << params.ran;
+	writer.write(ranState.str());
+	writer.write(params.penaltyCapacity);
+	writer.write(params.penaltyDuration);
+
+	population.writeState(writer);
+	localSearch.writeState(writer);
+	for (std::unique_ptr <OffspringWorker> & worker : workers) worker->localSearch.writeState(writer);
+
+	// Only one file written at a time. The file is replaced only once complete, so that an interruption does not corrupt the last checkpoint
+	if (checkpointWriting.valid()) checkpointWriting.get();
+	checkpointWriting = std::async(std::launch::async, [fileName, this](const std::string & buffer)
+	{
+		std::string tempFileName = fileName + ".tmp";
+		std::ofstream myfile(tempFileName, std::ios::binary);
+		if (myfile.is_open() && myfile.write(buffer.data(), (std::streamsize)buffer.size()))
+		{
+			myfile.close();
+			std::remove(fileName.c_str());
+			if (std::rename(tempFileName.c_str(), fileName.c_str()) == 0) return;
+		}
+		params.log("----- IMPOSSIBLE TO WRITE CHECKPOINT: ", fileName);
+	}, std::move(writer.buffer));
+}
+
+void Genetic::readCheckpoint(std::string fileName)
+{
+	std::ifstream myfile(fileName, std::ios::binary);
+	if (!myfile.is_open()) throw std::string("Impossible to open checkpoint file: " + fileName);
+	CheckpointReader reader(myfile);
+
+	std::string header;
+	int version, nbClients, nbVehicles, nbWorkers;
+	double vehicleCapacity;
+	reader.read(header);
+	reader.read(version);
+	if (header != "MDM-HGS-CVRP CHECKPOINT" || version != CHECKPOINT_VERSION) throw std::string("Invalid or incompatible checkpoint file: " + fileName);
+	reader.read(nbClients);
+	reader.read(nbVehicles);
+	reader.read(vehicleCapacity);
+	if (nbClients != params.nbClients || nbVehicles != params.nbVehicles || vehicleCapacity != params.vehicleCapacity) throw std::string("Checkpoint created for a different instance or fleet size");
+	reader.read(nbWorkers);
+	if (nbWorkers != (int)workers.size()) throw std::string("Checkpoint created with a different number of threads");
+
+	double elapsedTime;
+	std::string ranState;
+	reader.read(nbIter);
+	reader.read(nbIterNonProd);
+	reader.read(nbRestarts);
+	reader.read(lastDecompositionIter);
+	reader.read(elapsedTime);
+	reader.read(ranState);
+	reader.read(params.penaltyCapacity);
+	reader.read(params.penaltyDuration);
+
+	population.readState(reader);
+	localSearch.readState(reader);
+	for (std::unique_ptr <OffspringWorker> & worker : workers) worker->localSearch.readState(reader);
+
+	// The random number generator is restored last, since constructing the individuals of the population draws random numbers
+	std::istringstream(ranState) >> params.ran;
+	params.setElapsedTime(elapsedTime);
+	isResumed = true;
+}
+
 Genetic::Genetic(Params & params) : 
 	params(params), 
 	split(params),
 	localSearch(params),
 	population(params,this->split,this->localSearch),
-	offspring(params){}
+	offspring(params),
+	checkpointInterval(60.),
+	telemetryInterval(1.),
+	nbIter(0),
+	nbIterNonProd(1),
+	nbRestarts(0),
+	isResumed(false),
+	lastDecompositionIter(0),
+	batchID(0),
+	nbWorkersRunning(0),
+	stopWorkers(false)
+{
+	if (params.ap.nbThreads > 1)
+	{
+		for (int i = 0; i < params.ap.nbThreads; i++)
+			workers.push_back(std::unique_ptr <OffspringWorker>(new OffspringWorker(params)));
+		for (int i = 1; i < params.ap.nbThreads; i++)
+			threads.emplace_back(&Genetic::workerLoop, this, std::ref(*workers[i]));
+	}
+	nextOffspring = (int)workers.size();
+}
+
+LocalSearchStats Genetic::getLocalSearchStats() const
+{
+	LocalSearchStats total = localSearch.stats;
+	for (const std::unique_ptr <OffspringWorker> & worker : workers)
+	{
+		const LocalSearchStats & stats = worker->localSearch.stats;
+		for (int op = 0; op < LS_NB_OPERATORS; op++)
+		{
+			total.operators[op].nbEvaluations += stats.operators[op].nbEvaluations;
+			total.operators[op].nbPruned += stats.operators[op].nbPruned;
+			total.operators[op].nbImprovements += stats.operators[op].nbImprovements;
+			total.operators[op].totalGain += stats.operators[op].totalGain;
+			total.operators[op].nbSampledEvaluations += stats.operators[op].nbSampledEvaluations;
+			total.operators[op].sampledCycles += stats.operators[op].sampledCycles;
+		}
+		total.nbRouteUpdates += stats.nbRouteUpdates;
+		total.totalRouteLength += stats.totalRouteLength;
+	}
+	return total;
+}
+
+Genetic::~Genetic()
+{
+	{
+		std::lock_guard <std::mutex> lock(batchMutex);
+		stopWorkers = true;
+	}
+	batchStarted.notify_all();
+	for (std::thread & thread : threads) thread.join();
+}
 
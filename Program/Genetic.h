@@ -26,6 +26,41 @@ SOFTWARE.*/
 #include "Population.h"
 #include "Individual.h"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <future>
+#include <atomic>
+
+// Structures used to generate one offspring of a batch (when several offspring are generated in parallel)
+struct OffspringWorker
+{
+	std::minstd_rand ran;					// Random number generator of the worker, reseeded for each offspring
+	Split split;							// Split algorithm
+	LocalSearch localSearch;				// Local Search structure
+	const Individual * parent1;				// First parent, selected by the main thread
+	const Individual * parent2;				// Second parent, selected by the main thread
+	unsigned int seed;						// Seed drawn by the main thread for this offspring
+	Individual offspring;					// Offspring after crossover and local search
+	Individual repairedOffspring;			// Offspring after the repair attempt (if any)
+	bool hasRepair;							// Tells whether a repair has been attempted on the offspring
+	std::exception_ptr exception;			// Exception raised while generating the offspring (rethrown by the main thread)
+
+	OffspringWorker(Params & params) : split(params), localSearch(params, ran), offspring(params), repairedOffspring(params) {}
+};
+
+// Subproblem of a decomposition phase: the clients of a group of routes of the best feasible solution, and the routes obtained after its improvement
+struct DecompositionSubproblem
+{
+	std::vector <int> routeIndices;					// Routes of the best feasible solution forming the subproblem
+	unsigned int seed;								// Seed drawn by the main thread for this subproblem
+	std::vector < std::vector <int> > routes;		// Improved routes (or the initial ones if the search did not improve them), in the numbering of the complete problem
+	std::exception_ptr exception;					// Exception raised while solving the subproblem (rethrown by the main thread)
+	std::string error;								// Error of the solver on the subproblem (logged by the main thread, the routes being kept)
+};
+
 class Genetic
 {
 public:
@@ -36,14 +71,91 @@ public:
 	Population population;			// Population (public for now to give access to the solutions, but should be be improved later on)
 	Individual offspring;			// First individual to be used as input for the crossover
 
-	// OX Crossover
-	void crossoverOX(Individual & result, const Individual & parent1, const Individual & parent2);
+	std::string checkpointPath;		// Path of the checkpoint file written periodically during the search (no checkpoint if empty)
+	double checkpointInterval;		// Minimum time (in seconds) between two checkpoints
+	std::string telemetryPath;		// Path of the telemetry file (JSON lines) written during the search (no telemetry if empty)
+	double telemetryInterval;		// Time (in seconds) between two state records of the telemetry
+	std::function <bool()> stopCallback;	// Polled at each iteration (optional), and by the threads of the decomposition phases (one call at a time). Returning TRUE stops the search
+
+	// Crossover selected by params.ap.crossoverType
+	void crossover(Individual & result, const Individual & parent1, const Individual & parent2, Split & split, std::minstd_rand & ran);
+
+	// OX Crossover, completed by the given Split algorithm
+	void crossoverOX(Individual & result, const Individual & parent1, const Individual & parent2, Split & split, std::minstd_rand & ran);
+
+	// SREX Crossover (selective route exchange): consecutive routes of the first parent are replaced by the routes of the second parent which overlap them most
+	// The clients served twice are removed from the routes of the first parent, and the missing clients are inserted at their cheapest (penalized) positions, so that no Split is needed
+	void crossoverSREX(Individual & result, const Individual & parent1, const Individual & parent2, std::minstd_rand & ran);
 
     // Running the genetic algorithm until maxIterNonProd consecutive iterations or a time limit
     void run() ;
 
+	// Writes the complete state of the search in a binary checkpoint file (the file itself is written in background)
+	void writeCheckpoint(std::string fileName);
+
+	// Restores the state of the search from a checkpoint file, so that the next call to run() continues the search where it was left
+	void readCheckpoint(std::string fileName);
+
+	// Counters of the local search operators, summed over the local search of the main thread and the ones of the workers (null unless built with the HGS_LS_STATS option)
+	LocalSearchStats getLocalSearchStats() const;
+
 	// Constructor
 	Genetic(Params & params);
+
+	// Destructor
+	~Genetic();
+
+private:
+
+	/* STATE OF THE RUN */
+	int nbIter;								// Number of iterations since the beginning of the search
+	int nbIterNonProd;						// Number of iterations since the last improvement of the best solution of the restart
+	int nbRestarts;							// Number of restarts of the population
+	bool isResumed;							// Tells whether the state of the search has been restored from a checkpoint
+	std::future <void> checkpointWriting;	// Checkpoint file being written in background
+
+	/* DECOMPOSITION (ONLY ON INSTANCES OF AT LEAST decompositionMinClients CLIENTS) */
+	int lastDecompositionIter;				// Iteration of the last decomposition phase
+
+	/* TELEMETRY (ONLY WHEN telemetryPath IS SET) */
+	std::unique_ptr <Telemetry> telemetry;	// Telemetry stream of the current run
+	double lastTelemetryTime;				// Elapsed time, number of iterations and local search time at the last state record
+	int lastTelemetryIter;
+	double lastTelemetryLSTime;
+
+	/* BATCH GENERATION OF OFFSPRING (ONLY USED WHEN nbThreads > 1) */
+	std::vector < std::unique_ptr <OffspringWorker> > workers;	// One worker per offspring of a batch (the first one runs in the main thread)
+	std::vector < std::thread > threads;	// Threads running the other workers
+	int nextOffspring;						// Index of the next offspring of the current batch to be inserted in the population
+	int batchID;							// Index of the current batch
+	int nbWorkersRunning;					// Number of threads still generating an offspring of the current batch
+	bool stopWorkers;						// Tells the threads to terminate
+	std::mutex batchMutex;
+	std::condition_variable batchStarted;
+	std::condition_variable batchFinished;
+
+	// Selects the parents of a new batch of offspring and generates them in parallel
+	void generateBatch();
+
+	// Generates the offspring of a worker: crossover, Split and local search (with a possible repair)
+	void generateOffspring(OffspringWorker & worker);
+
+	// Loop run by each thread, generating one offspring for each batch
+	void workerLoop(OffspringWorker & worker);
+
+	// Inserts the next offspring of the current batch in the population (generating a new batch if needed)
+	// Returns TRUE if a new best solution of the run has been found
+	bool addNextOffspring();
+
+	// Adds a record to the telemetry stream
+	void recordTelemetry(TelemetryRecord::Event event);
+
+	// Decomposition phase: partitions the routes of the best feasible solution by polar angle, improves each group of routes as a subproblem (on up to nbThreads threads),
+	// and inserts the reassembled solution in the population. Returns TRUE if a new best solution of the run has been found
+	bool decompose();
+
+	// Solves a subproblem of the decomposition with its own Params and Genetic, starting from its initial routes. The search stops early when isStopped returns TRUE
+	void solveSubproblem(DecompositionSubproblem & subproblem, const Individual & incumbent, int nbVehicles, const std::function <bool()> & isStopped);
 };
 
 #endif
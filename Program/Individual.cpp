@@ -5,6 +5,7 @@
 void Individual::evaluateCompleteCost(const Params & params)
 {
 	eval = EvalIndiv();
+	edgeHash = 0;
 	for (int r = 0; r < params.nbVehicles; r++)
 	{
 		if (!chromR[r].empty())
@@ -13,6 +14,7 @@ void Individual::evaluateCompleteCost(const Params & params)
 			double load = params.cli[chromR[r][0]].demand;
 			double service = params.cli[chromR[r][0]].serviceDuration;
 			predecessors[chromR[r][0]] = 0;
+			edgeHash += edgeKey(0, chromR[r][0]) + edgeKey(chromR[r][chromR[r].size()-1], 0);
 			for (int i = 1; i < (int)chromR[r].size(); i++)
 			{
 				distance += params.timeCost[chromR[r][i-1]][chromR[r][i]];
@@ -20,6 +22,7 @@ void Individual::evaluateCompleteCost(const Params & params)
 				service += params.cli[chromR[r][i]].serviceDuration;
 				predecessors[chromR[r][i]] = chromR[r][i-1];
 				successors[chromR[r][i-1]] = chromR[r][i];
+				edgeHash += edgeKey(chromR[r][i-1], chromR[r][i]);
 			}
 			successors[chromR[r][chromR[r].size()-1]] = 0;
 			distance += params.timeCost[chromR[r][chromR[r].size()-1]][0];
@@ -34,6 +37,39 @@ void Individual::evaluateCompleteCost(const Params & params)
 	eval.isFeasible = (eval.capacityExcess < MY_EPSILON && eval.durationExcess < MY_EPSILON);
 }
 
+void Individual::writeState(CheckpointWriter & writer) const
+{
+	writer.write(eval.penalizedCost);
+	writer.write(eval.nbRoutes);
+	writer.write(eval.distance);
+	writer.write(eval.capacityExcess);
+	writer.write(eval.durationExcess);
+	writer.write(eval.isFeasible);
+	writer.write(chromT);
+	writer.write(chromR);
+	writer.write(successors);
+	writer.write(predecessors);
+	writer.write(biasedFitness);
+	writer.write(edgeHash);
+}
+
+void Individual::readState(CheckpointReader & reader)
+{
+	reader.read(eval.penalizedCost);
+	reader.read(eval.nbRoutes);
+	reader.read(eval.distance);
+	reader.read(eval.capacityExcess);
+	reader.read(eval.durationExcess);
+	reader.read(eval.isFeasible);
+	reader.read(chromT);
+	reader.read(chromR);
+	reader.read(successors);
+	reader.read(predecessors);
+	reader.read(biasedFitness);
+	reader.read(edgeHash);
+	indivsPerProximity.clear();
+}
+
 Individual::Individual(Params & params, bool rcws, std::vector < std::vector <int> >* pattern)
 {
 	successors = std::vector <int>(params.nbClients + 1);
@@ -43,39 +79,78 @@ Individual::Individual(Params & params, bool rcws, std::vector < std::vector <in
 
 	if (rcws)	// initialize the individual with a randomized version of the Clarke & Wright savings heuristic
 	{
+		TraceSpan span(params.trace.get(), "rcw");
 		std::vector <bool> inRoute = std::vector <bool>(params.nbClients + 1, false);
 		std::vector <bool> interior = std::vector <bool>(params.nbClients + 1, false);
 		std::vector <double> load = std::vector <double>(params.nbVehicles, 0);
 		std::vector <Savings> tournamentSavings = std::vector <Savings>(6);
 		std::vector <double> selectionProbabilities = std::vector <double>(6);
 		int tournamentSavingsOccupancy = 0;
-		unsigned savingsCount = 0;
+		int savingsCount = 0;
 		int nextEmptyRoute = 0;
 		int nbVehicles = params.nbVehicles;
 
+		// Routes under construction, as doubly linked lists without orientation (each client knows its neighbors in the route, -1 at the ends)
+		// A route is reversed by swapping its front and back, and two routes are merged by linking their ends, in O(1)
+		std::vector <int> neighborA = std::vector <int>(params.nbClients + 1, -1);
+		std::vector <int> neighborB = std::vector <int>(params.nbClients + 1, -1);
+		std::vector <int> routeFront = std::vector <int>(params.nbVehicles, -1);
+		std::vector <int> routeBack = std::vector <int>(params.nbVehicles, -1);
+		std::vector <int> routeSize = std::vector <int>(params.nbVehicles, 0);
+		std::vector <int> endpointRoute = std::vector <int>(params.nbClients + 1, -1); // Route of each client located at an end of its route
+		auto link = [&](int c1, int c2)
+		{
+			if (neighborA[c1] == -1) neighborA[c1] = c2; else neighborB[c1] = c2;
+			if (neighborA[c2] == -1) neighborA[c2] = c1; else neighborB[c2] = c1;
+		};
+		auto openRoute = [&]()
+		{
+			if (nextEmptyRoute == nbVehicles)
+			{
+				nbVehicles++;
+				load.push_back(0);
+				routeFront.push_back(-1);
+				routeBack.push_back(-1);
+				routeSize.push_back(0);
+			}
+			return nextEmptyRoute;
+		};
+		auto clearRoute = [&](int r)
+		{
+			routeFront[r] = -1;
+			routeBack[r] = -1;
+			routeSize[r] = 0;
+			load[r] = 0;
+			if (r < nextEmptyRoute) nextEmptyRoute = r;
+		};
+
 		if (pattern)	// insert pattern
 			for (unsigned r = 0; r < pattern->size(); r++)
 			{
-				if (nextEmptyRoute == nbVehicles)
-				{
-					nbVehicles++;
-					chromR.push_back(std::vector <int>());
-					load.push_back(0);
-				}
+				int route = openRoute();
 				for (unsigned c = 0; c < (*pattern)[r].size(); c++)
 				{
-					chromR[nextEmptyRoute].push_back((*pattern)[r][c]);
-					load[nextEmptyRoute] += params.cli[(*pattern)[r][c]].demand;
-					inRoute[(*pattern)[r][c]] = true;
+					int client = (*pattern)[r][c];
+					if (c) link(routeBack[route], client);
+					else routeFront[route] = client;
+					routeBack[route] = client;
+					routeSize[route]++;
+					load[route] += params.cli[client].demand;
+					inRoute[client] = true;
 					if (c && c != (*pattern)[r].size() - 1)
-						interior[(*pattern)[r][c]] = true;
+						interior[client] = true;
 				}
-				while (nextEmptyRoute < nbVehicles && !chromR[nextEmptyRoute].empty()) nextEmptyRoute++;
+				if (routeSize[route] > 0)
+				{
+					endpointRoute[routeFront[route]] = route;
+					endpointRoute[routeBack[route]] = route;
+				}
+				while (nextEmptyRoute < nbVehicles && routeSize[nextEmptyRoute] > 0) nextEmptyRoute++;
 			}
 
-		while (savingsCount < params.savingsList.size() || tournamentSavingsOccupancy > 0)
+		while (savingsCount < params.nbSavings || tournamentSavingsOccupancy > 0)
 		{
-			int tournamentSize = std::min(2 + std::rand() % 5, (int)params.savingsList.size() - (int)savingsCount + tournamentSavingsOccupancy);
+			int tournamentSize = std::min(2 + (int)(params.ran() % 5), params.nbSavings - savingsCount + tournamentSavingsOccupancy);
 
 			while (tournamentSavingsOccupancy < tournamentSize)
 			{
@@ -85,7 +160,7 @@ Individual::Individual(Params & params, bool rcws, std::vector < std::vector <in
 				else
 				{
 					tournamentSize = tournamentSavingsOccupancy;
-					savingsCount = params.savingsList.size();
+					savingsCount = params.nbSavings;
 				}
 			}
 
@@ -97,177 +172,73 @@ Individual::Individual(Params & params, bool rcws, std::vector < std::vector <in
 				selectionProbabilities[i] = tournamentSavings[i].value / tournamentSavingsSum;
 
 			double cumulativeProbability = 0;
-			double rand = (double)std::rand() / RAND_MAX;
+			double rand = (double)params.ran() / (double)params.ran.max();
 
 			for (int i = 0; i < tournamentSize; i++)
 			{
 				if (rand <= selectionProbabilities[i] + cumulativeProbability)
 				{
 					//Process tournamentSavings[i]
-					if (params.cli[tournamentSavings[i].c1].demand + params.cli[tournamentSavings[i].c2].demand <= params.vehicleCapacity)
+					int c1 = tournamentSavings[i].c1;
+					int c2 = tournamentSavings[i].c2;
+					if (params.cli[c1].demand + params.cli[c2].demand <= params.vehicleCapacity)
 					{
-						if (!inRoute[tournamentSavings[i].c1] && !inRoute[tournamentSavings[i].c2])
-						{
-							if (nextEmptyRoute == nbVehicles)
-							{
-								nbVehicles++;
-								chromR.push_back(std::vector <int>());
-								load.push_back(0);
-							}
-							chromR[nextEmptyRoute].push_back(tournamentSavings[i].c1);
-							chromR[nextEmptyRoute].push_back(tournamentSavings[i].c2);
-							load[nextEmptyRoute] += params.cli[tournamentSavings[i].c1].demand + params.cli[tournamentSavings[i].c2].demand;
-							inRoute[tournamentSavings[i].c1] = true;
-							inRoute[tournamentSavings[i].c2] = true;
-							while (nextEmptyRoute < nbVehicles && !chromR[nextEmptyRoute].empty()) nextEmptyRoute++;
-						}
-						else if (inRoute[tournamentSavings[i].c1] && !interior[tournamentSavings[i].c1] && !inRoute[tournamentSavings[i].c2])
+						if (!inRoute[c1] && !inRoute[c2])
 						{
-							for (int r = 0; r < nbVehicles; r++)
-								if (!chromR[r].empty())
-								{
-									if (chromR[r].front() == tournamentSavings[i].c1)
-									{
-										if (load[r] + params.cli[tournamentSavings[i].c2].demand <= params.vehicleCapacity)
-										{
-											chromR[r].insert(chromR[r].begin(), tournamentSavings[i].c2);
-											load[r] += params.cli[tournamentSavings[i].c2].demand;
-											inRoute[tournamentSavings[i].c2] = true;
-											if (chromR[r].size() > 2)
-												interior[tournamentSavings[i].c1] = true;
-										}
-										break;
-									}
-									else if (chromR[r].back() == tournamentSavings[i].c1)
-									{
-										if (load[r] + params.cli[tournamentSavings[i].c2].demand <= params.vehicleCapacity)
-										{
-											chromR[r].push_back(tournamentSavings[i].c2);
-											load[r] += params.cli[tournamentSavings[i].c2].demand;
-											inRoute[tournamentSavings[i].c2] = true;
-											if (chromR[r].size() > 2)
-												interior[tournamentSavings[i].c1] = true;
-										}
-										break;
-									}
-								}
+							int r = openRoute();
+							link(c1, c2);
+							routeFront[r] = c1;
+							routeBack[r] = c2;
+							routeSize[r] = 2;
+							endpointRoute[c1] = r;
+							endpointRoute[c2] = r;
+							load[r] += params.cli[c1].demand + params.cli[c2].demand;
+							inRoute[c1] = true;
+							inRoute[c2] = true;
+							while (nextEmptyRoute < nbVehicles && routeSize[nextEmptyRoute] > 0) nextEmptyRoute++;
 						}
-						else if (inRoute[tournamentSavings[i].c2] && !interior[tournamentSavings[i].c2] && !inRoute[tournamentSavings[i].c1])
+						else if (inRoute[c1] != inRoute[c2] && !interior[inRoute[c1] ? c1 : c2])
 						{
-							for (int r = 0; r < nbVehicles; r++)
-								if (!chromR[r].empty())
-								{
-									if (chromR[r].front() == tournamentSavings[i].c2)
-									{
-										if (load[r] + params.cli[tournamentSavings[i].c1].demand <= params.vehicleCapacity)
-										{
-											chromR[r].insert(chromR[r].begin(), tournamentSavings[i].c1);
-											load[r] += params.cli[tournamentSavings[i].c1].demand;
-											inRoute[tournamentSavings[i].c1] = true;
-											if (chromR[r].size() > 2)
-												interior[tournamentSavings[i].c2] = true;
-										}
-										break;
-									}
-									else if (chromR[r].back() == tournamentSavings[i].c2)
-									{
-										if (load[r] + params.cli[tournamentSavings[i].c1].demand <= params.vehicleCapacity)
-										{
-											chromR[r].push_back(tournamentSavings[i].c1);
-											load[r] += params.cli[tournamentSavings[i].c1].demand;
-											inRoute[tournamentSavings[i].c1] = true;
-											if (chromR[r].size() > 2)
-												interior[tournamentSavings[i].c2] = true;
-										}
-										break;
-									}
-								}
+							// Extending the route which ends with the routed client
+							int routed = inRoute[c1] ? c1 : c2;
+							int added = inRoute[c1] ? c2 : c1;
+							int r = endpointRoute[routed];
+							if (load[r] + params.cli[added].demand <= params.vehicleCapacity)
+							{
+								link(routed, added);
+								if (routeFront[r] == routed) routeFront[r] = added;
+								else routeBack[r] = added;
+								routeSize[r]++;
+								endpointRoute[added] = r;
+								load[r] += params.cli[added].demand;
+								inRoute[added] = true;
+								if (routeSize[r] > 2)
+									interior[routed] = true;
+							}
 						}
-						else if (inRoute[tournamentSavings[i].c1] && !interior[tournamentSavings[i].c1] && inRoute[tournamentSavings[i].c2] && !interior[tournamentSavings[i].c2])
+						else if (inRoute[c1] && !interior[c1] && inRoute[c2] && !interior[c2])
 						{
-							int r1 = -1;
-							int r2 = -1;
-							int pos1 = 0;
-							int pos2 = 0;
-
-							for (int r = 0; r < nbVehicles; r++)
-								if (!chromR[r].empty())
-								{
-									if (chromR[r].front() == tournamentSavings[i].c1)
-									{
-										r1 = r;
-										pos1 = 0;
-									}
-									else if (chromR[r].back() == tournamentSavings[i].c1)
-									{
-										r1 = r;
-										pos1 = chromR[r].size() - 1;
-									}
-
-									if (chromR[r].front() == tournamentSavings[i].c2)
-									{
-										r2 = r;
-										pos2 = 0;
-									}
-									else if (chromR[r].back() == tournamentSavings[i].c2)
-									{
-										r2 = r;
-										pos2 = chromR[r].size() - 1;
-									}
-
-									if (r1 > -1 && r2 > -1)
-									{
-										if (r1 != r2 && load[r1] + load[r2] <= params.vehicleCapacity)
-										{
-											if (pos1 == 0)
-											{
-												if (pos2 == 0)
-												{
-													chromR[r1].insert(chromR[r1].begin(), chromR[r2].rbegin(), chromR[r2].rend());
-													load[r1] += load[r2];
-													chromR[r2].clear();
-													load[r2] = 0;
-													if (r2 < nextEmptyRoute) nextEmptyRoute = r2;
-												}
-												else
-												{
-													chromR[r2].insert(chromR[r2].end(), chromR[r1].begin(), chromR[r1].end());
-													load[r2] += load[r1];
-													chromR[r1].clear();
-													load[r1] = 0;
-													if (r1 < nextEmptyRoute) nextEmptyRoute = r1;
-												}
-
-												interior[tournamentSavings[i].c1] = true;
-												interior[tournamentSavings[i].c2] = true;
-											}
-											else if (pos2 == 0)
-											{
-												chromR[r1].insert(chromR[r1].end(), chromR[r2].begin(), chromR[r2].end());
-												load[r1] += load[r2];
-												chromR[r2].clear();
-												load[r2] = 0;
-												if (r2 < nextEmptyRoute) nextEmptyRoute = r2;
-
-												interior[tournamentSavings[i].c1] = true;
-												interior[tournamentSavings[i].c2] = true;
-											}
-											else
-											{
-												chromR[r1].insert(chromR[r1].end(), chromR[r2].rbegin(), chromR[r2].rend());
-												load[r1] += load[r2];
-												chromR[r2].clear();
-												load[r2] = 0;
-												if (r2 < nextEmptyRoute) nextEmptyRoute = r2;
-
-												interior[tournamentSavings[i].c1] = true;
-												interior[tournamentSavings[i].c2] = true;
-											}
-										}
+							int r1 = endpointRoute[c1];
+							int r2 = endpointRoute[c2];
+							if (r1 != r2 && load[r1] + load[r2] <= params.vehicleCapacity)
+							{
+								// Merging the two routes by linking c1 and c2, in the route of the client which is not at its front (or in r1)
+								bool isFront1 = (routeFront[r1] == c1);
+								bool isFront2 = (routeFront[r2] == c2);
+								int kept = (isFront1 && !isFront2) ? r2 : r1;
+								int removed = (kept == r1) ? r2 : r1;
+								int newEnd = (removed == r2) ? (isFront2 ? routeBack[r2] : routeFront[r2]) : routeBack[r1];
+								link(c1, c2);
+								if (kept == r1 && isFront1) routeFront[r1] = newEnd;
+								else routeBack[kept] = newEnd;
+								endpointRoute[newEnd] = kept;
+								routeSize[kept] += routeSize[removed];
+								load[kept] += load[removed];
+								clearRoute(removed);
 
-										break;
-									}
-								}
+								interior[c1] = true;
+								interior[c2] = true;
+							}
 						}
 					}
 
@@ -282,6 +253,17 @@ Individual::Individual(Params & params, bool rcws, std::vector < std::vector <in
 			}
 		}
 
+		// Writing the routes, from their front to their back
+		chromR.resize(nbVehicles);
+		for (int r = 0; r < nbVehicles; r++)
+			for (int previous = -1, c = routeFront[r]; c != -1; )
+			{
+				chromR[r].push_back(c);
+				int next = (neighborA[c] != previous) ? neighborA[c] : neighborB[c];
+				previous = c;
+				c = next;
+			}
+
 		int i = nextEmptyRoute + 1;
 		while (nextEmptyRoute < nbVehicles && i < nbVehicles)
 		{
@@ -345,5 +327,34 @@ Individual::Individual(Params & params, bool rcws, std::vector < std::vector <in
 		for (int i = 0; i < params.nbClients; i++) chromT[i] = i + 1;
 		std::shuffle(chromT.begin(), chromT.end(), params.ran);
 		eval.penalizedCost = 1.e30;
+		edgeHash = 0;
 	}
 }
+
+Individual::Individual(Params & params, const std::vector < std::vector <int> > & routes)
+{
+	successors = std::vector <int>(params.nbClients + 1);
+	predecessors = std::vector <int>(params.nbClients + 1);
+	chromR = std::vector < std::vector <int> >(params.nbVehicles);
+	chromT = std::vector <int>(params.nbClients);
+
+	std::vector <bool> isVisited = std::vector <bool>(params.nbClients + 1, false);
+	int nbRoutes = 0;
+	int c = 0;
+	for (const std::vector <int> & route : routes)
+	{
+		if (route.empty()) continue;
+		if (nbRoutes == params.nbVehicles) throw std::string("Initial solution with more routes than available vehicles");
+		for (int client : route)
+		{
+			if (client < 1 || client > params.nbClients || isVisited[client]) throw std::string("Initial solution with an invalid or repeated client: " + std::to_string(client));
+			isVisited[client] = true;
+			chromR[nbRoutes].push_back(client);
+			chromT[c++] = client;
+		}
+		nbRoutes++;
+	}
+	if (c != params.nbClients) throw std::string("Initial solution which does not visit all clients");
+
+	evaluateCompleteCost(params);
+}
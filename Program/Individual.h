@@ -24,6 +24,7 @@ SOFTWARE.*/
 #define INDIVIDUAL_H
 
 #include "Params.h"
+#include "Checkpoint.h"
 
 struct EvalIndiv
 {
@@ -46,13 +47,36 @@ public:
   std::vector < int > predecessors ;										// For each node, the predecessor in the solution (can be the depot 0)
   std::multiset < std::pair < double, Individual* > > indivsPerProximity ;	// The other individuals in the population, ordered by increasing proximity (the set container follows a natural ordering based on the first value of the pair)
   double biasedFitness;														// Biased fitness of the solution
+  uint64_t edgeHash;														// Hash of the set of edges of the solution (equal for clones, whatever the order and orientation of the routes)
 
   // Measuring cost and feasibility of an Individual from the information of chromR (needs chromR filled and access to Params)
+  // Also computes the edge hash of the individual
   void evaluateCompleteCost(const Params & params);
 
+  // Pseudo-random key of an edge, summed over the edges of the solution to obtain its hash (Zobrist hashing, with a sum so that the double edges of the single-client routes do not cancel out)
+  static uint64_t edgeKey(int i, int j) { return hashMix((uint64_t)std::min<int>(i, j) << 32 | (uint64_t)std::max<int>(i, j)); }
+
+  // Mixing function of SplitMix64, turning a value into a pseudo-random key
+  static uint64_t hashMix(uint64_t value)
+  {
+	  value += 0x9E3779B97F4A7C15ULL;
+	  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	  return value ^ (value >> 31);
+  }
+
+  // Writes the individual in a checkpoint (the proximity structure is not written, it is rebuilt by the population)
+  void writeState(CheckpointWriter & writer) const;
+
+  // Reads the individual from a checkpoint
+  void readState(CheckpointReader & reader);
+
   // Constructor:
   // - If rcws is true, uses a randomized version of the Clarke & Wright savings heuristic (initialized with a pattern, if provided)
   // - Otherwise (default), constructs a random individual containing only a giant tour with a shuffled visit order
   Individual(Params & params, bool rcws=false, std::vector < std::vector <int> >* pattern=NULL);
+
+  // Constructor of an individual from a given set of routes (with the clients in internal numbering)
+  Individual(Params & params, const std::vector < std::vector <int> > & routes);
 };
 #endif
@@ -5,8 +5,9 @@
 #include <fstream>
 #include <cmath>
 #include "InstanceCVRPLIB.h"
+#include "Params.h"
 
-InstanceCVRPLIB::InstanceCVRPLIB(std::string pathToInstance, bool isRoundingInteger = true)
+InstanceCVRPLIB::InstanceCVRPLIB(std::string pathToInstance, bool isRoundingInteger, const AlgorithmParameters & ap)
 {
 	std::string content, content2, content3;
 	double serviceTimeData = 0.;
@@ -58,20 +59,8 @@ InstanceCVRPLIB::InstanceCVRPLIB(std::string pathToInstance, bool isRoundingInte
 			service_time[i] = (i == 0) ? 0. : serviceTimeData ;
 		}
 
-		// Calculating 2D Euclidean Distance
-		dist_mtx = std::vector < std::vector< double > >(nbClients + 1, std::vector <double>(nbClients + 1));
-		for (int i = 0; i <= nbClients; i++)
-		{
-			for (int j = 0; j <= nbClients; j++)
-			{
-				dist_mtx[i][j] = std::sqrt(
-					(x_coords[i] - x_coords[j]) * (x_coords[i] - x_coords[j])
-					+ (y_coords[i] - y_coords[j]) * (y_coords[i] - y_coords[j])
-				);
-
-				if (isRoundingInteger) dist_mtx[i][j] = round(dist_mtx[i][j]);
-			}
-		}
+		// Calculating 2D Euclidean Distance, directly in the storage layout of Params
+		dist_mtx = DistanceMatrix::buildEuclidean(x_coords, y_coords, isRoundingInteger, Params::isPackedStorage(nbClients + 1, true, ap));
 
 		// Reading depot information (in all current instances the depot is represented as node 1, the program will return an error otherwise)
 		inputFile >> content >> content2 >> content3 >> content3;
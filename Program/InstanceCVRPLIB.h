@@ -6,13 +6,15 @@
 #define INSTANCECVRPLIB_H
 #include<string>
 #include<vector>
+#include "AlgorithmParameters.h"
+#include "DistanceMatrix.h"
 
 class InstanceCVRPLIB
 {
 public:
 	std::vector<double> x_coords;
 	std::vector<double> y_coords;
-	std::vector< std::vector<double> > dist_mtx;
+	DistanceMatrix dist_mtx;								// Euclidean distance matrix, in the storage layout chosen by Params::isPackedStorage (to be moved into Params)
 	std::vector<double> service_time;
 	std::vector<double> demands;
 	double durationLimit = 1.e30;							// Route duration limit
@@ -20,7 +22,7 @@ public:
 	bool isDurationConstraint = false;						// Indicates if the problem includes duration constraints
 	int nbClients ;											// Number of clients (excluding the depot)
 
-	InstanceCVRPLIB(std::string pathToInstance, bool isRoundingInteger);
+	InstanceCVRPLIB(std::string pathToInstance, bool isRoundingInteger, const AlgorithmParameters & ap);
 };
 
 
@@ -0,0 +1,179 @@
+#include "InstanceCache.h"
+#include "InstanceCVRPLIB.h"
+#include "Params.h"
+
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#define INSTANCE_CACHE_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(Savings) == 16, "Unexpected layout of the Savings structure");
+
+// Size of a section of the cache file, padded to keep all sections aligned on 8 bytes
+static std::size_t paddedSize(std::size_t size) { return (size + 7) & ~(std::size_t)7; }
+
+uint64_t InstanceCache::hashFile(std::string path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) throw std::string("Impossible to open instance file: " + path);
+	uint64_t hash = 14695981039346656037ULL;
+	char chunk[65536];
+	while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+		for (std::streamsize i = 0; i < file.gcount(); i++)
+		{
+			hash ^= (unsigned char)chunk[i];
+			hash *= 1099511628211ULL;
+		}
+	return hash;
+}
+
+bool InstanceCache::map(std::string path)
+{
+#ifdef INSTANCE_CACHE_NO_MMAP
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return false;
+	mappedSize = (std::size_t)file.tellg();
+	buffer = std::vector <uint64_t>((mappedSize + 7) / 8);
+	file.seekg(0);
+	if (!file.read(reinterpret_cast<char *>(buffer.data()), (std::streamsize)mappedSize)) return false;
+	mappedData = reinterpret_cast<const char *>(buffer.data());
+	return true;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat fileStatus;
+	if (fstat(fd, &fileStatus) != 0 || fileStatus.st_size == 0) { close(fd); return false; }
+	void * address = mmap(nullptr, (std::size_t)fileStatus.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (address == MAP_FAILED) return false;
+	mappedData = static_cast<const char *>(address);
+	mappedSize = (std::size_t)fileStatus.st_size;
+	return true;
+#endif
+}
+
+InstanceCache::InstanceCache(std::string pathInstance, bool isRoundingInteger, const AlgorithmParameters & ap) : isValid(false), mappedData(nullptr), mappedSize(0)
+{
+	if (!map(pathInstance + ".hgscache") || mappedSize < sizeof(InstanceCacheHeader)) return;
+
+	InstanceCacheHeader header;
+	std::memcpy(&header, mappedData, sizeof(header));
+	if (std::memcmp(header.magic, "HGSCACHE", 8) != 0 || header.version != INSTANCE_CACHE_VERSION) return;
+	if (header.isRoundingInteger != (int)isRoundingInteger || header.nbGranular != ap.nbGranular || header.spatialOrdering != std::max<int>(0, ap.spatialOrdering)) return;
+	if (header.nbSavings == 0 && ap.randGeneration < 1.0 && header.nbNodes > 2) return; // The savings list is needed but was not computed
+	if (header.isPacked != (int)Params::isPackedStorage((int)header.nbNodes, header.isSymmetric != 0, ap)) return;
+	if (header.instanceHash != hashFile(pathInstance)) return;
+	isValid = readSections();
+}
+
+InstanceCache::InstanceCache(const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params) : isValid(false), mappedData(nullptr), mappedSize(0)
+{
+	std::string content = serialize(0, cvrp, isRoundingInteger, params);
+	buffer = std::vector <uint64_t>(content.size() / 8);
+	std::memcpy(buffer.data(), content.data(), content.size());
+	mappedData = reinterpret_cast<const char *>(buffer.data());
+	mappedSize = content.size();
+	isValid = readSections();
+}
+
+bool InstanceCache::readSections()
+{
+	InstanceCacheHeader header;
+	std::memcpy(&header, mappedData, sizeof(header));
+	nbNodes = (int)header.nbNodes;
+	vehicleCapacity = header.vehicleCapacity;
+	durationLimit = header.durationLimit;
+	isDurationConstraint = (header.isDurationConstraint != 0);
+	isSymmetric = (header.isSymmetric != 0);
+	isPacked = (header.isPacked != 0);
+	maxDist = header.maxDist;
+	nbSavings = (int)header.nbSavings;
+
+	std::size_t offset = paddedSize(sizeof(InstanceCacheHeader));
+	auto section = [&](std::size_t size) { const char * start = mappedData + offset; offset += paddedSize(size); return start; };
+	x_coords = reinterpret_cast<const double *>(section(nbNodes * sizeof(double)));
+	y_coords = reinterpret_cast<const double *>(section(nbNodes * sizeof(double)));
+	service_time = reinterpret_cast<const double *>(section(nbNodes * sizeof(double)));
+	demands = reinterpret_cast<const double *>(section(nbNodes * sizeof(double)));
+	distances = reinterpret_cast<const double *>(section(DistanceMatrix(nbNodes, isPacked, nullptr).nbValues() * sizeof(double)));
+	savings = reinterpret_cast<const Savings *>(section(header.nbSavings * sizeof(Savings)));
+	originalIndex = reinterpret_cast<const int *>(section(nbNodes * sizeof(int)));
+	neighborOffsets = reinterpret_cast<const int *>(section((nbNodes + 1) * sizeof(int)));
+	neighbors = reinterpret_cast<const int *>(section(header.nbNeighbors * sizeof(int)));
+	return (offset == mappedSize && neighborOffsets[nbNodes] == (int)header.nbNeighbors);
+}
+
+InstanceCache::~InstanceCache()
+{
+#ifndef INSTANCE_CACHE_NO_MMAP
+	if (mappedData != nullptr && buffer.empty()) munmap(const_cast<char *>(mappedData), mappedSize);
+#endif
+}
+
+std::string InstanceCache::serialize(uint64_t instanceHash, const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params)
+{
+	int nbNodes = params.nbClients + 1;
+	std::vector <int> neighborOffsets(nbNodes + 1, 0);
+	for (int i = 0; i < nbNodes; i++) neighborOffsets[i + 1] = neighborOffsets[i] + (int)params.correlatedVertices[i].size();
+
+	InstanceCacheHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, "HGSCACHE", 8);
+	header.version = INSTANCE_CACHE_VERSION;
+	header.nbNodes = (uint32_t)nbNodes;
+	header.instanceHash = instanceHash;
+	header.isRoundingInteger = (int)isRoundingInteger;
+	header.nbGranular = params.ap.nbGranular;
+	header.spatialOrdering = std::max<int>(0, params.ap.spatialOrdering);
+	header.isDurationConstraint = (int)params.isDurationConstraint;
+	header.isSymmetric = (int)params.isSymmetric;
+	header.isPacked = (int)params.timeCost.isPacked();
+	header.vehicleCapacity = params.vehicleCapacity;
+	header.durationLimit = params.durationLimit;
+	header.maxDist = params.maxDist;
+	header.nbNeighbors = (uint64_t)neighborOffsets[nbNodes];
+	header.nbSavings = (uint64_t)params.nbSavings;
+
+	std::string content;
+	auto section = [&](const void * data, std::size_t size) { content.append(static_cast<const char *>(data), size); content.append(paddedSize(size) - size, '\0'); };
+	section(&header, sizeof(header));
+	section(cvrp.x_coords.data(), nbNodes * sizeof(double));
+	section(cvrp.y_coords.data(), nbNodes * sizeof(double));
+	section(cvrp.service_time.data(), nbNodes * sizeof(double));
+	section(cvrp.demands.data(), nbNodes * sizeof(double));
+	section(params.timeCost.begin(), params.timeCost.nbValues() * sizeof(double));
+	section(params.savingsList, params.nbSavings * sizeof(Savings));
+	section(params.originalIndex.data(), nbNodes * sizeof(int));
+	section(neighborOffsets.data(), (nbNodes + 1) * sizeof(int));
+	for (int i = 0; i < nbNodes; i++) content.append(reinterpret_cast<const char *>(params.correlatedVertices[i].data()), params.correlatedVertices[i].size() * sizeof(int));
+	content.append(paddedSize(header.nbNeighbors * sizeof(int)) - header.nbNeighbors * sizeof(int), '\0');
+	return content;
+}
+
+void InstanceCache::write(std::string pathInstance, const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params)
+{
+	std::string content = serialize(hashFile(pathInstance), cvrp, isRoundingInteger, params);
+
+	// Written in a temporary file first, so that the processes reading the cache never see an incomplete file
+	std::string pathCache = pathInstance + ".hgscache";
+	std::string pathTemp = pathCache + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+	std::ofstream file(pathTemp, std::ios::binary);
+	if (!file.is_open() || !file.write(content.data(), (std::streamsize)content.size()))
+	{
+		if (params.verbose) params.log("----- IMPOSSIBLE TO WRITE INSTANCE CACHE: ", pathCache);
+		return;
+	}
+	file.close();
+	if (std::rename(pathTemp.c_str(), pathCache.c_str()) != 0) // On Windows, an existing (outdated) cache has to be removed first
+	{
+		std::remove(pathCache.c_str());
+		if (std::rename(pathTemp.c_str(), pathCache.c_str()) != 0) std::remove(pathTemp.c_str());
+	}
+}
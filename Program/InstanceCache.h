@@ -0,0 +1,97 @@
+#ifndef INSTANCECACHE_H
+#define INSTANCECACHE_H
+
+#include "AlgorithmParameters.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#define INSTANCE_CACHE_VERSION 2
+
+struct Savings;
+class Params;
+class InstanceCVRPLIB;
+
+// Header of the cache file, followed by the data sections (all aligned on 8 bytes)
+struct InstanceCacheHeader
+{
+	char magic[8];					// "HGSCACHE"
+	uint32_t version;				// Version of the format (INSTANCE_CACHE_VERSION)
+	uint32_t nbNodes;				// Number of nodes (clients + depot)
+	uint64_t instanceHash;			// Hash of the content of the instance file
+	int32_t isRoundingInteger;		// Parameters on which the preprocessed data depends
+	int32_t nbGranular;
+	int32_t spatialOrdering;
+	int32_t isDurationConstraint;	// Instance data
+	int32_t isSymmetric;			// Whether the distance matrix is symmetric
+	int32_t isPacked;				// Storage of the distance matrix: packed lower triangle (1) or full matrix (0)
+	double vehicleCapacity;
+	double durationLimit;
+	double maxDist;					// Maximum distance between two clients
+	uint64_t nbNeighbors;			// Total size of the granular neighborhoods
+	uint64_t nbSavings;				// Size of the savings list (0 if it was not computed)
+};
+
+// Binary sidecar file (<instance>.hgscache) holding the instance data along with the preprocessing of Params: distance matrix, savings list and granular neighborhoods
+// The file is memory-mapped read-only (read in memory on Windows), so that the processes solving the same instance share it and skip the preprocessing
+class InstanceCache
+{
+public:
+
+	bool isValid;					// Tells whether a cache matching the instance file and the parameters has been found
+	int nbNodes;					// Number of nodes (clients + depot)
+	double vehicleCapacity;			// Capacity limit
+	double durationLimit;			// Route duration limit
+	bool isDurationConstraint;		// Indicates if the problem includes duration constraints
+	bool isSymmetric;				// Whether the distance matrix is symmetric
+	bool isPacked;					// Whether the distance matrix is stored as a packed lower triangle
+	double maxDist;					// Maximum distance between two clients
+
+	/* VIEWS ON THE CACHED DATA */
+	const double * x_coords;		// Coordinates, service times and demands, in the numbering of the input data
+	const double * y_coords;
+	const double * service_time;
+	const double * demands;
+	const int * originalIndex;		// For each node, its index in the input data
+	const double * distances;		// Distance matrix in the internal numbering (in the layout of DistanceMatrix)
+	const int * neighborOffsets;	// Granular neighborhood of client i: neighbors[neighborOffsets[i]] ... neighbors[neighborOffsets[i+1]-1]
+	const int * neighbors;
+	const Savings * savings;		// Sorted savings list
+	int nbSavings;					// Size of the savings list
+
+	// Opens the cache of an instance (isValid is false if there is no cache, or if it does not match the instance file or the parameters)
+	InstanceCache(std::string pathInstance, bool isRoundingInteger, const AlgorithmParameters & ap);
+
+	// Builds the cache of an instance in memory, from its data and the preprocessing done by Params (used to share the preprocessing between the searches of a batch)
+	InstanceCache(const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params);
+
+	// Destructor (unmaps the file)
+	~InstanceCache();
+
+	// Writes the cache of an instance from its data and the preprocessing done by Params
+	static void write(std::string pathInstance, const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params);
+
+	InstanceCache(const InstanceCache &) = delete;
+	InstanceCache & operator=(const InstanceCache &) = delete;
+
+private:
+
+	const char * mappedData;		// Content of the cache file
+	std::size_t mappedSize;			// Size of the cache file
+	std::vector <uint64_t> buffer;	// Content of the cache file when it cannot be memory-mapped
+
+	// Hash (FNV-1a) of the content of a file
+	static uint64_t hashFile(std::string path);
+
+	// Content of the cache file of an instance
+	static std::string serialize(uint64_t instanceHash, const InstanceCVRPLIB & cvrp, bool isRoundingInteger, const Params & params);
+
+	// Sets the views on the data sections. Returns FALSE if the sections do not match the size of the content
+	bool readSections();
+
+	// Maps the cache file in memory. Returns FALSE if the file does not exist
+	bool map(std::string path);
+};
+
+#endif
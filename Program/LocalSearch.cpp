@@ -1,17 +1,48 @@
 #include "LocalSearch.h" 
 
+#ifdef HGS_LS_STATS
+#ifdef __x86_64__
+#include <x86intrin.h>
+#endif
+#define LS_EVALUATE(op, move) evaluateWithStats(op, &LocalSearch::move)
+#define LS_PRUNED pruned()
+#else
+#define LS_EVALUATE(op, move) move()
+#define LS_PRUNED false
+#endif
+
 void LocalSearch::run(Individual & indiv, double penaltyCapacityLS, double penaltyDurationLS)
 {
+	// The result of the search is reused if this solution has already been improved with the same penalty values
+	uint64_t cacheKey = 0;
+	if (params.ap.lsCacheSize > 0)
+	{
+		uint64_t penaltyBits[2];
+		std::memcpy(&penaltyBits[0], &penaltyCapacityLS, sizeof(double));
+		std::memcpy(&penaltyBits[1], &penaltyDurationLS, sizeof(double));
+		cacheKey = Individual::hashMix(indiv.edgeHash + Individual::hashMix(penaltyBits[0]) + 3 * Individual::hashMix(penaltyBits[1]));
+		auto cachedResult = cache.find(cacheKey);
+		if (cachedResult != cache.end())
+		{
+			indiv = cachedResult->second;
+			return;
+		}
+	}
+
+	TraceSpan span(params.trace.get(), "LocalSearch::run");
+	std::chrono::steady_clock::time_point startTime;
+	if (isRunTimeMeasured) startTime = std::chrono::steady_clock::now();
+
 	this->penaltyCapacityLS = penaltyCapacityLS;
 	this->penaltyDurationLS = penaltyDurationLS;
 	loadIndividual(indiv);
 
 	// Shuffling the order of the nodes explored by the LS to allow for more diversity in the search
-	std::shuffle(orderNodes.begin(), orderNodes.end(), params.ran);
-	std::shuffle(orderRoutes.begin(), orderRoutes.end(), params.ran);
+	std::shuffle(orderNodes.begin(), orderNodes.end(), ran);
+	std::shuffle(orderRoutes.begin(), orderRoutes.end(), ran);
 	for (int i = 1; i <= params.nbClients; i++)
-		if (params.ran() % params.ap.nbGranular == 0)  // O(n/nbGranular) calls to the inner function on average, to achieve linear-time complexity overall
-			std::shuffle(params.correlatedVertices[i].begin(), params.correlatedVertices[i].end(), params.ran);
+		if (ran() % params.ap.nbGranular == 0)  // O(n/nbGranular) calls to the inner function on average, to achieve linear-time complexity overall
+			std::shuffle(correlatedVertices[i].begin(), correlatedVertices[i].end(), ran);
 
 	searchCompleted = false;
 	for (loopID = 0; !searchCompleted; loopID++)
@@ -20,39 +51,46 @@ void LocalSearch::run(Individual & indiv, double penaltyCapacityLS, double penal
 			searchCompleted = true;
 
 		/* CLASSICAL ROUTE IMPROVEMENT (RI) MOVES SUBJECT TO A PROXIMITY RESTRICTION */
+		TraceSpan spanRI(params.trace.get(), "RI");
 		for (int posU = 0; posU < params.nbClients; posU++)
 		{
 			nodeU = &clients[orderNodes[posU]];
 			int lastTestRINodeU = nodeU->whenLastTestedRI;
 			nodeU->whenLastTestedRI = nbMoves;
-			for (int posV = 0; posV < (int)params.correlatedVertices[nodeU->cour].size(); posV++)
+
+			// The neighbors are only visited if a route involving nodeU or one of its neighbors has been modified (the flags are raised by updateRouteData)
+			// The sweep itself still visits every client, rather than a list of the flagged ones: the moves towards an empty route below are tested for every client,
+			// and the time stamp of the last test of a clean client is refreshed, which filters its later evaluations. Skipping these clients would change the search
+			int nbNeighborsU = (loopID == 0 || isNeighborhoodModified[nodeU->cour]) ? (int)correlatedVertices[nodeU->cour].size() : 0;
+			isNeighborhoodModified[nodeU->cour] = false;
+			for (int posV = 0; posV < nbNeighborsU; posV++)
 			{
-				nodeV = &clients[params.correlatedVertices[nodeU->cour][posV]];
+				nodeV = &clients[correlatedVertices[nodeU->cour][posV]];
 				if (loopID == 0 || std::max<int>(nodeU->route->whenLastModified, nodeV->route->whenLastModified) > lastTestRINodeU) // only evaluate moves involving routes that have been modified since last move evaluations for nodeU
 				{
 					// Randomizing the order of the neighborhoods within this loop does not matter much as we are already randomizing the order of the node pairs (and it's not very common to find improving moves of different types for the same node pair)
 					setLocalVariablesRouteU();
 					setLocalVariablesRouteV();
-					if (move1()) continue; // RELOCATE
-					if (move2()) continue; // RELOCATE
-					if (move3()) continue; // RELOCATE
-					if (nodeUIndex <= nodeVIndex && move4()) continue; // SWAP
-					if (move5()) continue; // SWAP
-					if (nodeUIndex <= nodeVIndex && move6()) continue; // SWAP
-					if (intraRouteMove && move7()) continue; // 2-OPT
-					if (!intraRouteMove && move8()) continue; // 2-OPT*
-					if (!intraRouteMove && move9()) continue; // 2-OPT*
+					if (LS_EVALUATE(LS_MOVE1, move1)) continue; // RELOCATE
+					if (LS_EVALUATE(LS_MOVE2, move2)) continue; // RELOCATE
+					if (LS_EVALUATE(LS_MOVE3, move3)) continue; // RELOCATE
+					if (nodeUIndex <= nodeVIndex && LS_EVALUATE(LS_MOVE4, move4)) continue; // SWAP
+					if (LS_EVALUATE(LS_MOVE5, move5)) continue; // SWAP
+					if (nodeUIndex <= nodeVIndex && LS_EVALUATE(LS_MOVE6, move6)) continue; // SWAP
+					if (intraRouteMove && LS_EVALUATE(LS_MOVE7, move7)) continue; // 2-OPT
+					if (!intraRouteMove && LS_EVALUATE(LS_MOVE8, move8)) continue; // 2-OPT*
+					if (!intraRouteMove && LS_EVALUATE(LS_MOVE9, move9)) continue; // 2-OPT*
 
 					// Trying moves that insert nodeU directly after the depot
 					if (nodeV->prev->isDepot)
 					{
 						nodeV = nodeV->prev;
 						setLocalVariablesRouteV();
-						if (move1()) continue; // RELOCATE
-						if (move2()) continue; // RELOCATE
-						if (move3()) continue; // RELOCATE
-						if (!intraRouteMove && move8()) continue; // 2-OPT*
-						if (!intraRouteMove && move9()) continue; // 2-OPT*
+						if (LS_EVALUATE(LS_MOVE1_DEPOT, move1)) continue; // RELOCATE
+						if (LS_EVALUATE(LS_MOVE2_DEPOT, move2)) continue; // RELOCATE
+						if (LS_EVALUATE(LS_MOVE3_DEPOT, move3)) continue; // RELOCATE
+						if (!intraRouteMove && LS_EVALUATE(LS_MOVE8_DEPOT, move8)) continue; // 2-OPT*
+						if (!intraRouteMove && LS_EVALUATE(LS_MOVE9_DEPOT, move9)) continue; // 2-OPT*
 					}
 				}
 			}
@@ -63,16 +101,19 @@ void LocalSearch::run(Individual & indiv, double penaltyCapacityLS, double penal
 				nodeV = routes[*emptyRoutes.begin()].depot;
 				setLocalVariablesRouteU();
 				setLocalVariablesRouteV();
-				if (move1()) continue; // RELOCATE
-				if (move2()) continue; // RELOCATE
-				if (move3()) continue; // RELOCATE
-				if (move9()) continue; // 2-OPT*
+				if (LS_EVALUATE(LS_MOVE1_EMPTY, move1)) continue; // RELOCATE
+				if (LS_EVALUATE(LS_MOVE2_EMPTY, move2)) continue; // RELOCATE
+				if (LS_EVALUATE(LS_MOVE3_EMPTY, move3)) continue; // RELOCATE
+				if (LS_EVALUATE(LS_MOVE9_EMPTY, move9)) continue; // 2-OPT*
 			}
 		}
 
+		spanRI.close();
+
 		if (params.ap.useSwapStar == 1 && params.areCoordinatesProvided)
 		{
 			/* (SWAP*) MOVES LIMITED TO ROUTE PAIRS WHOSE CIRCLE SECTORS OVERLAP */
+			TraceSpan spanSwapStar(params.trace.get(), "SWAP*");
 			for (int rU = 0; rU < params.nbVehicles; rU++)
 			{
 				routeU = &routes[orderRoutes[rU]];
@@ -85,7 +126,7 @@ void LocalSearch::run(Individual & indiv, double penaltyCapacityLS, double penal
 						&& (loopID == 0 || std::max<int>(routeU->whenLastModified, routeV->whenLastModified)
 							> lastTestSWAPStarRouteU))
 						if (CircleSector::overlap(routeU->sector, routeV->sector))
-							swapStar();
+							LS_EVALUATE(LS_SWAPSTAR, swapStar);
 				}
 			}
 		}
@@ -93,6 +134,17 @@ void LocalSearch::run(Individual & indiv, double penaltyCapacityLS, double penal
 
 	// Register the solution produced by the LS in the individual
 	exportIndividual(indiv);
+	if (isRunTimeMeasured) runTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+	if (params.ap.lsCacheSize > 0 && cache.emplace(cacheKey, indiv).second)
+	{
+		cacheOrder.push_back(cacheKey);
+		if ((int)cacheOrder.size() > params.ap.lsCacheSize)
+		{
+			cache.erase(cacheOrder.front());
+			cacheOrder.pop_front();
+		}
+	}
 }
 
 void LocalSearch::setLocalVariablesRouteU()
@@ -132,7 +184,7 @@ bool LocalSearch::move1()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - serviceU)
 			+ penaltyExcessLoad(routeU->load - loadU)
@@ -162,7 +214,7 @@ bool LocalSearch::move2()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - params.timeCost[nodeUIndex][nodeXIndex] - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load - loadU - loadX)
@@ -193,7 +245,7 @@ bool LocalSearch::move3()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load - loadU - loadX)
@@ -224,7 +276,7 @@ bool LocalSearch::move4()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU + serviceV - serviceU)
 			+ penaltyExcessLoad(routeU->load + loadV - loadU)
@@ -254,7 +306,7 @@ bool LocalSearch::move5()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - params.timeCost[nodeUIndex][nodeXIndex] + serviceV - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load + loadV - loadU - loadX)
@@ -285,7 +337,7 @@ bool LocalSearch::move6()
 	if (!intraRouteMove)
 	{
 		// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return false;
+		if (costSuppU + costSuppV >= routeU->penalty + routeV->penalty) return LS_PRUNED;
 
 		costSuppU += penaltyExcessDuration(routeU->duration + costSuppU - params.timeCost[nodeUIndex][nodeXIndex] + params.timeCost[nodeVIndex][nodeYIndex] + serviceV + serviceY - serviceU - serviceX)
 			+ penaltyExcessLoad(routeU->load + loadV + loadY - loadU - loadX)
@@ -347,7 +399,7 @@ bool LocalSearch::move8()
 		- routeU->penalty - routeV->penalty;
 
 	// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-	if (cost >= 0) return false;
+	if (cost >= 0) return LS_PRUNED;
 		
 	cost += penaltyExcessDuration(nodeU->cumulatedTime + nodeV->cumulatedTime + nodeV->cumulatedReversalDistance + params.timeCost[nodeUIndex][nodeVIndex])
 		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - params.timeCost[nodeUIndex][nodeXIndex] + routeU->reversalDistance - nodeX->cumulatedReversalDistance + routeV->duration - nodeV->cumulatedTime - params.timeCost[nodeVIndex][nodeYIndex] + params.timeCost[nodeXIndex][nodeYIndex])
@@ -426,7 +478,7 @@ bool LocalSearch::move9()
 		        - routeU->penalty - routeV->penalty;
 
 	// Early move pruning to save CPU time. Guarantees that this move cannot improve without checking additional (load, duration...) constraints
-	if (cost >= 0) return false;
+	if (cost >= 0) return LS_PRUNED;
 		
 	cost += penaltyExcessDuration(nodeU->cumulatedTime + routeV->duration - nodeV->cumulatedTime - params.timeCost[nodeVIndex][nodeYIndex] + params.timeCost[nodeUIndex][nodeYIndex])
 		+ penaltyExcessDuration(routeU->duration - nodeU->cumulatedTime - params.timeCost[nodeUIndex][nodeXIndex] + nodeV->cumulatedTime + params.timeCost[nodeVIndex][nodeXIndex])
@@ -682,12 +734,16 @@ void LocalSearch::updateRouteData(Route * myRoute)
 		mynode->position = myplace;
 		myload += params.cli[mynode->cour].demand;
 		mytime += params.timeCost[mynode->prev->cour][mynode->cour] + params.cli[mynode->cour].serviceDuration;
-		myReversalDistance += params.timeCost[mynode->cour][mynode->prev->cour] - params.timeCost[mynode->prev->cour][mynode->cour] ;
+		if (!params.isSymmetric) // The reversal distances remain null with a symmetric matrix
+			myReversalDistance += params.timeCost[mynode->cour][mynode->prev->cour] - params.timeCost[mynode->prev->cour][mynode->cour] ;
 		mynode->cumulatedLoad = myload;
 		mynode->cumulatedTime = mytime;
 		mynode->cumulatedReversalDistance = myReversalDistance;
 		if (!mynode->isDepot)
 		{
+			isNeighborhoodModified[mynode->cour] = true;
+			for (int i = reverseNeighborOffsets[mynode->cour]; i < reverseNeighborOffsets[mynode->cour + 1]; i++)
+				isNeighborhoodModified[reverseNeighbors[i]] = true;
 			cumulatedX += params.cli[mynode->cour].coordX;
 			cumulatedY += params.cli[mynode->cour].coordY;
 			if (firstIt) myRoute->sector.initialize(params.cli[mynode->cour].polarAngle);
@@ -704,6 +760,11 @@ void LocalSearch::updateRouteData(Route * myRoute)
 	// Remember "when" this route has been last modified (will be used to filter unnecessary move evaluations)
 	myRoute->whenLastModified = nbMoves ;
 
+#ifdef HGS_LS_STATS
+	stats.nbRouteUpdates++;
+	stats.totalRouteLength += myRoute->nbCustomers;
+#endif
+
 	if (myRoute->nbCustomers == 0)
 	{
 		myRoute->polarAngleBarycenter = 1.e30;
@@ -716,6 +777,50 @@ void LocalSearch::updateRouteData(Route * myRoute)
 	}
 }
 
+#ifdef HGS_LS_STATS
+bool LocalSearch::evaluateWithStats(int op, bool (LocalSearch::*move)())
+{
+	LocalSearchOperatorStats & opStats = stats.operators[op];
+	Route * myRouteU = routeU;
+	Route * myRouteV = routeV;
+	double costBefore = myRouteU->duration + myRouteU->penalty + (myRouteV != myRouteU ? myRouteV->duration + myRouteV->penalty : 0.);
+	bool isSampled = (opStats.nbEvaluations++ % LS_STATS_SAMPLING == 0);
+	uint64_t startCycles = isSampled ? readCycles() : 0;
+	currentOperator = op;
+	bool isImproving = (this->*move)();
+	if (isSampled)
+	{
+		opStats.sampledCycles += readCycles() - startCycles;
+		opStats.nbSampledEvaluations++;
+	}
+	if (isImproving)
+	{
+		opStats.nbImprovements++;
+		opStats.totalGain += costBefore - myRouteU->duration - myRouteU->penalty - (myRouteV != myRouteU ? myRouteV->duration + myRouteV->penalty : 0.);
+	}
+	return isImproving;
+}
+
+uint64_t LocalSearch::readCycles()
+{
+#ifdef __x86_64__
+	return __rdtsc();
+#else
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+#endif
+
+extern "C" const char * ls_operator_name(int op)
+{
+	static const char * names[LS_NB_OPERATORS] = {
+		"move1", "move2", "move3", "move4", "move5", "move6", "move7", "move8", "move9",
+		"move1-depot", "move2-depot", "move3-depot", "move8-depot", "move9-depot",
+		"move1-empty", "move2-empty", "move3-empty", "move9-empty",
+		"swapStar" };
+	return (op >= 0 && op < LS_NB_OPERATORS) ? names[op] : "unknown";
+}
+
 void LocalSearch::loadIndividual(const Individual & indiv)
 {
 	emptyRoutes.clear();
@@ -759,6 +864,19 @@ void LocalSearch::loadIndividual(const Individual & indiv)
 		clients[i].whenLastTestedRI = -1;
 }
 
+std::vector <int> LocalSearch::routesByPolarAngle(const Individual & indiv)
+{
+	loadIndividual(indiv);
+	std::vector < std::pair <double, int> > routePolarAngles;
+	for (int r = 0; r < params.nbVehicles; r++)
+		if (routes[r].nbCustomers > 0) routePolarAngles.push_back(std::pair <double, int>(routes[r].polarAngleBarycenter, r));
+	std::sort(routePolarAngles.begin(), routePolarAngles.end());
+
+	std::vector <int> result;
+	for (const std::pair <double, int> & route : routePolarAngles) result.push_back(route.second);
+	return result;
+}
+
 void LocalSearch::exportIndividual(Individual & indiv)
 {
 	std::vector < std::pair <double, int> > routePolarAngles ;
@@ -783,8 +901,49 @@ void LocalSearch::exportIndividual(Individual & indiv)
 	indiv.evaluateCompleteCost(params);
 }
 
-LocalSearch::LocalSearch(Params & params) : params (params)
+void LocalSearch::writeState(CheckpointWriter & writer) const
 {
+	writer.write(orderNodes);
+	writer.write(orderRoutes);
+	writer.write(correlatedVertices);
+	writer.write((uint64_t)cacheOrder.size());
+	for (uint64_t cacheKey : cacheOrder)
+	{
+		writer.write(cacheKey);
+		cache.at(cacheKey).writeState(writer);
+	}
+}
+
+void LocalSearch::readState(CheckpointReader & reader)
+{
+	reader.read(orderNodes);
+	reader.read(orderRoutes);
+	reader.read(correlatedVertices);
+	cache.clear();
+	cacheOrder.clear();
+	uint64_t cacheSize = reader.readSize();
+	for (uint64_t i = 0; i < cacheSize; i++)
+	{
+		uint64_t cacheKey;
+		reader.read(cacheKey);
+		Individual & cachedResult = cache.emplace(cacheKey, Individual(params)).first->second;
+		cachedResult.readState(reader);
+		cacheOrder.push_back(cacheKey);
+	}
+	if ((int)orderNodes.size() != params.nbClients || (int)orderRoutes.size() != params.nbVehicles || (int)correlatedVertices.size() != params.nbClients + 1)
+		throw std::string("Checkpoint does not match the local search structures");
+}
+
+LocalSearch::LocalSearch(Params & params) : LocalSearch(params, params.ran) {}
+
+LocalSearch::LocalSearch(Params & params, std::minstd_rand & ran) : params (params), ran (ran), correlatedVertices (params.correlatedVertices)
+{
+	isRunTimeMeasured = false;
+	runTime = 0.;
+	std::memset(&stats, 0, sizeof(stats));
+#ifdef HGS_LS_STATS
+	stats.isEnabled = 1;
+#endif
 	clients = std::vector < Node >(params.nbClients + 1);
 	routes = std::vector < Route >(params.nbVehicles);
 	depots = std::vector < Node >(params.nbVehicles);
@@ -809,5 +968,15 @@ LocalSearch::LocalSearch(Params & params) : params (params)
 	}
 	for (int i = 1 ; i <= params.nbClients ; i++) orderNodes.push_back(i);
 	for (int r = 0 ; r < params.nbVehicles ; r++) orderRoutes.push_back(r);
+
+	reverseNeighborOffsets = std::vector <int>(params.nbClients + 2, 0);
+	for (int u = 1; u <= params.nbClients; u++)
+		for (int v : params.correlatedVertices[u]) reverseNeighborOffsets[v + 1]++;
+	for (int i = 0; i <= params.nbClients; i++) reverseNeighborOffsets[i + 1] += reverseNeighborOffsets[i];
+	reverseNeighbors = std::vector <int>(reverseNeighborOffsets[params.nbClients + 1]);
+	std::vector <int> position(reverseNeighborOffsets.begin(), reverseNeighborOffsets.end() - 1);
+	for (int u = 1; u <= params.nbClients; u++)
+		for (int v : params.correlatedVertices[u]) reverseNeighbors[position[v]++] = u;
+	isNeighborhoodModified = std::vector <char>(params.nbClients + 1, true);
 }
 
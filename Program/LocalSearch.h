@@ -24,6 +24,10 @@ SOFTWARE.*/
 #define LOCALSEARCH_H
 
 #include "Individual.h"
+#include "LocalSearchStats.h"
+#include <unordered_map>
+#include <deque>
+#include <cstring>
 
 struct Node ;
 
@@ -54,7 +58,7 @@ struct Node
 	Route * route;						// Pointer towards the associated route
 	double cumulatedLoad;				// Cumulated load on this route until the customer (including itself)
 	double cumulatedTime;				// Cumulated time on this route until the customer (including itself)
-	double cumulatedReversalDistance;	// Difference of cost if the segment of route (0...cour) is reversed (useful for 2-opt moves with asymmetric problems)
+	double cumulatedReversalDistance;	// Difference of cost if the segment of route (0...cour) is reversed (useful for 2-opt moves with asymmetric problems, null otherwise)
 	double deltaRemoval;				// Difference of cost in the current route if the node is removed (used in SWAP*)
 };
 
@@ -113,11 +117,18 @@ class LocalSearch
 private:
 	
 	Params & params ;							// Problem parameters
+	std::minstd_rand & ran ;					// Random number generator used to randomize the search (the one of Params, unless the local search runs in its own thread)
+	std::vector < std::vector < int > > correlatedVertices;	// Granular neighborhoods (own copy of the lists of Params, since their order is randomized during the search)
 	bool searchCompleted;						// Tells whether all moves have been evaluated without success
 	int nbMoves;								// Total number of moves (RI and SWAP*) applied during the local search. Attention: this is not only a simple counter, it is also used to avoid repeating move evaluations
 	std::vector < int > orderNodes;				// Randomized order for checking the nodes in the RI local search
 	std::vector < int > orderRoutes;			// Randomized order for checking the routes in the SWAP* local search
+	std::vector < int > reverseNeighborOffsets;	// The clients having client i in their granular neighborhood are reverseNeighbors[reverseNeighborOffsets[i]] ... reverseNeighbors[reverseNeighborOffsets[i+1]-1]
+	std::vector < int > reverseNeighbors;
+	std::vector < char > isNeighborhoodModified;	// For each client, tells if a route visiting this client or one of its neighbors has been modified since its last RI move evaluations
 	std::set < int > emptyRoutes;				// indices of all empty routes
+	std::unordered_map < uint64_t, Individual > cache;	// Results of the last runs (if ap.lsCacheSize > 0), by hash of the initial solution and penalty values
+	std::deque < uint64_t > cacheOrder;			// Keys of the cached results, from the oldest to the most recent
 	int loopID;									// Current loop index
 
 	/* THE SOLUTION IS REPRESENTED AS A LINKED LIST OF ELEMENTS */
@@ -175,8 +186,20 @@ private:
 	static void swapNode(Node * U, Node * V) ;		// Solution update: Swap U and V							   
 	void updateRouteData(Route * myRoute);			// Updates the preprocessed data of a route
 
+#ifdef HGS_LS_STATS
+	/* INSTRUMENTATION OF THE OPERATORS (ONLY COMPILED IN WITH THE HGS_LS_STATS OPTION) */
+	int currentOperator;							// Operator being evaluated
+	bool evaluateWithStats(int op, bool (LocalSearch::*move)());	// Evaluates a move of the given operator and updates its counters
+	bool pruned() { stats.operators[currentOperator].nbPruned++; return false; }	// Counts an early pruning of the current operator
+	static uint64_t readCycles();					// Time-stamp counter (or steady clock in nanoseconds) used for the sampled timings
+#endif
+
 	public:
 
+	LocalSearchStats stats;							// Counters of the operators, summed over all runs (remain null unless built with the HGS_LS_STATS option)
+	bool isRunTimeMeasured;							// Tells whether the time spent in run() is measured (for the telemetry)
+	double runTime;									// Total time spent in run() in seconds, if measured
+
 	// Run the local search with the specified penalty values
 	void run(Individual & indiv, double penaltyCapacityLS, double penaltyDurationLS);
 
@@ -186,8 +209,20 @@ private:
 	// Exporting the LS solution into an individual and calculating the penalized cost according to the original penalty weights from Params
 	void exportIndividual(Individual & indiv);
 
+	// Loads an individual and returns the indices of its non-empty routes, ordered by the polar angle of their barycenter around the depot
+	std::vector <int> routesByPolarAngle(const Individual & indiv);
+
+	// Writes the randomized search orders and the cached results in a checkpoint (the only state kept from one run to the next)
+	void writeState(CheckpointWriter & writer) const;
+
+	// Reads the randomized search orders and the cached results from a checkpoint
+	void readState(CheckpointReader & reader);
+
 	// Constructor
 	LocalSearch(Params & params);
+
+	// Constructor for a local search using its own random number generator (e.g., to be run in a separate thread)
+	LocalSearch(Params & params, std::minstd_rand & ran);
 };
 
 #endif
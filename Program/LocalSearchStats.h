@@ -0,0 +1,44 @@
+#ifndef LOCALSEARCHSTATS_H
+#define LOCALSEARCHSTATS_H
+
+#include <stdint.h>
+
+// Operators of the local search, as counted by the instrumentation (only compiled in with the HGS_LS_STATS option)
+// The depot variants insert after the depot preceding a neighbor, the empty-route variants move to an empty route
+enum LocalSearchOperator
+{
+	LS_MOVE1, LS_MOVE2, LS_MOVE3, LS_MOVE4, LS_MOVE5, LS_MOVE6, LS_MOVE7, LS_MOVE8, LS_MOVE9,
+	LS_MOVE1_DEPOT, LS_MOVE2_DEPOT, LS_MOVE3_DEPOT, LS_MOVE8_DEPOT, LS_MOVE9_DEPOT,
+	LS_MOVE1_EMPTY, LS_MOVE2_EMPTY, LS_MOVE3_EMPTY, LS_MOVE9_EMPTY,
+	LS_SWAPSTAR,
+	LS_NB_OPERATORS
+};
+
+// Counters of one operator
+struct LocalSearchOperatorStats
+{
+	uint64_t nbEvaluations;			// Number of evaluations of the operator
+	uint64_t nbPruned;				// Number of evaluations stopped by the early pruning test (before checking the load and duration constraints)
+	uint64_t nbImprovements;		// Number of improving moves applied
+	double totalGain;				// Total decrease of the penalized cost brought by these moves
+	uint64_t nbSampledEvaluations;	// Number of evaluations timed (one in LS_STATS_SAMPLING)
+	uint64_t sampledCycles;			// Time spent in the timed evaluations, in CPU cycles (nanoseconds on platforms without time-stamp counter)
+};
+
+// Counters of the local search (sums over all local search runs, including the ones of the worker threads)
+struct LocalSearchStats
+{
+	char isEnabled;					// Tells whether the solver has been built with the HGS_LS_STATS option (all counters stay null otherwise)
+	struct LocalSearchOperatorStats operators[LS_NB_OPERATORS];
+	uint64_t nbRouteUpdates;		// Number of calls to updateRouteData
+	uint64_t totalRouteLength;		// Total number of customers in the updated routes
+};
+
+#define LS_STATS_SAMPLING 64
+
+#ifdef __cplusplus
+extern "C"
+#endif
+const char * ls_operator_name(int op);
+
+#endif
@@ -1,29 +1,100 @@
 #include "Params.h"
+#include <mutex>
+
+// Serializes the lines of log written on the standard output, when several searches run concurrently without log sink
+static std::mutex standardOutputMutex;
+
+void Params::writeLog(const std::string & line) const
+{
+	if (logSink) { logSink(line); return; }
+	std::lock_guard <std::mutex> lock(standardOutputMutex);
+	std::cout << line << std::endl;
+}
 
 // A comparator for sorting the savings list (when the Clarke & Wright heuristic is used)
 bool compSavings(const Savings &s1, const Savings &s2) { return s1.value > s2.value; }
 
-// The universal constructor for both executable and shared library
-// When the executable is run from the commandline,
-// it will first generate an CVRPLIB instance from .vrp file, then supply necessary information.
-Params::Params(
-	const std::vector<double>& x_coords,
-	const std::vector<double>& y_coords,
-	const std::vector<std::vector<double>>& dist_mtx,
-	const std::vector<double>& service_time,
-	const std::vector<double>& demands,
-	double vehicleCapacity,
-	double durationLimit,
-	int nbVeh,
-	bool isDurationConstraint,
-	bool verbose,
-	const AlgorithmParameters& ap
-)
-	: ap(ap), isDurationConstraint(isDurationConstraint), nbVehicles(nbVeh), durationLimit(durationLimit),
-	  vehicleCapacity(vehicleCapacity), timeCost(dist_mtx), verbose(verbose)
+// Position of a point of the 65536 x 65536 grid along the Morton (Z-order) curve: interleaves the bits of both coordinates
+unsigned long long mortonIndex(unsigned x, unsigned y)
+{
+	unsigned long long d = 0;
+	for (int b = 15; b >= 0; b--)
+		d = (d << 2) | (((x >> b) & 1) << 1) | ((y >> b) & 1);
+	return d;
+}
+
+// Position of a point of the 65536 x 65536 grid along the Hilbert curve
+unsigned long long hilbertIndex(unsigned x, unsigned y)
+{
+	unsigned long long d = 0;
+	for (unsigned s = 32768; s > 0; s /= 2)
+	{
+		unsigned rx = (x & s) > 0;
+		unsigned ry = (y & s) > 0;
+		d += (unsigned long long)s * s * ((3 * rx) ^ ry);
+		if (ry == 0) // Rotate the quadrant so that the curve stays continuous
+		{
+			if (rx == 1) { x = 65535 - x; y = 65535 - y; }
+			std::swap(x, y);
+		}
+	}
+	return d;
+}
+
+void Params::reorderNodes(const std::vector<double>& x_coords, const std::vector<double>& y_coords, int nbNodes)
+{
+	originalIndex = std::vector<int>(nbNodes);
+	for (int i = 0; i < nbNodes; i++) originalIndex[i] = i;
+	if (ap.spatialOrdering > 0 && (int)x_coords.size() == nbNodes && (int)y_coords.size() == nbNodes)
+	{
+		// Scaling the coordinates to the grid of the space-filling curve
+		double minX = *std::min_element(x_coords.begin(), x_coords.end());
+		double maxX = *std::max_element(x_coords.begin(), x_coords.end());
+		double minY = *std::min_element(y_coords.begin(), y_coords.end());
+		double maxY = *std::max_element(y_coords.begin(), y_coords.end());
+		double scale = 65535. / std::max<double>(MY_EPSILON, std::max<double>(maxX - minX, maxY - minY));
+
+		// Sorting the clients by position on the curve (the depot keeps index 0)
+		std::vector<std::pair<unsigned long long, int> > curvePositions;
+		for (int i = 1; i < nbNodes; i++)
+		{
+			unsigned x = (unsigned)((x_coords[i] - minX) * scale);
+			unsigned y = (unsigned)((y_coords[i] - minY) * scale);
+			curvePositions.emplace_back(ap.spatialOrdering == 1 ? mortonIndex(x, y) : hilbertIndex(x, y), i);
+		}
+		std::sort(curvePositions.begin(), curvePositions.end());
+		for (int i = 1; i < nbNodes; i++) originalIndex[i] = curvePositions[i - 1].second;
+	}
+}
+
+// Tells whether a square matrix of the given size is symmetric
+template <typename Matrix> static bool isSymmetricMatrix(const Matrix& dist_mtx, int nbNodes)
+{
+	for (int i = 0; i < nbNodes; i++)
+		for (int j = 0; j < i; j++)
+			if (dist_mtx[i][j] != dist_mtx[j][i]) return false;
+	return true;
+}
+
+template <typename Matrix> void Params::fillDistances(const Matrix& dist_mtx, int nbNodes)
+{
+	isSymmetric = isSymmetricMatrix(dist_mtx, nbNodes);
+	timeCost = DistanceMatrix(nbNodes, isPackedStorage(nbNodes, isSymmetric, ap));
+	for (int i = 0; i < nbNodes; i++)
+		for (int j = 0; j < (timeCost.isPacked() ? i + 1 : nbNodes); j++)
+			timeCost.set(i, j, dist_mtx[originalIndex[i]][originalIndex[j]]);
+}
+
+bool Params::isPackedStorage(int nbNodes, bool isSymmetric, const AlgorithmParameters& ap)
+{
+	// Packing trades speed for memory (the LS is noticeably slower on a packed matrix), so by default it is only used when the full matrix would take hundreds of MB
+	return isSymmetric && (ap.packedDistances == 1 || (ap.packedDistances < 0 && nbNodes >= 5000));
+}
+
+void Params::initializeClients(const std::vector<double>& x_coords, const std::vector<double>& y_coords, const std::vector<double>& service_time, const std::vector<double>& demands)
 {
 	// This marks the starting time of the algorithm
-	startTime = clock();
+	startTime = std::chrono::steady_clock::now();
 
 	nbClients = (int)demands.size() - 1; // Need to substract the depot from the number of nodes
 	totalDemand = 0.;
@@ -41,8 +112,8 @@ Params::Params(
 		// If useSwapStar==false, x_coords and y_coords may be empty.
 		if (ap.useSwapStar == 1 && areCoordinatesProvided)
 		{
-			cli[i].coordX = x_coords[i];
-			cli[i].coordY = y_coords[i];
+			cli[i].coordX = x_coords[originalIndex[i]];
+			cli[i].coordY = y_coords[originalIndex[i]];
 			cli[i].polarAngle = CircleSector::positive_mod(
 				32768. * atan2(cli[i].coordY - cli[0].coordY, cli[i].coordX - cli[0].coordX) / PI);
 		}
@@ -53,27 +124,107 @@ Params::Params(
 			cli[i].polarAngle = 0.0;
 		}
 
-		cli[i].serviceDuration = service_time[i];
-		cli[i].demand = demands[i];
+		cli[i].serviceDuration = service_time[originalIndex[i]];
+		cli[i].demand = demands[originalIndex[i]];
 		if (cli[i].demand > maxDemand) maxDemand = cli[i].demand;
 		totalDemand += cli[i].demand;
 	}
 
 	if (verbose && ap.useSwapStar == 1 && !areCoordinatesProvided)
-		std::cout << "----- NO COORDINATES HAVE BEEN PROVIDED, SWAP* NEIGHBORHOOD WILL BE DEACTIVATED BY DEFAULT" << std::endl;
+		log("----- NO COORDINATES HAVE BEEN PROVIDED, SWAP* NEIGHBORHOOD WILL BE DEACTIVATED BY DEFAULT");
+	if (verbose && ap.spatialOrdering > 0 && !areCoordinatesProvided)
+		log("----- NO COORDINATES HAVE BEEN PROVIDED, SPATIAL ORDERING OF THE CLIENTS WILL BE DEACTIVATED");
 
 	// Default initialization if the number of vehicles has not been provided by the user
 	if (nbVehicles == INT_MAX)
 	{
 		nbVehicles = (int)std::ceil(1.3*totalDemand/vehicleCapacity) + 3;  // Safety margin: 30% + 3 more vehicles than the trivial bin packing LB
 		if (verbose) 
-			std::cout << "----- FLEET SIZE WAS NOT SPECIFIED: DEFAULT INITIALIZATION TO " << nbVehicles << " VEHICLES" << std::endl;
+			log("----- FLEET SIZE WAS NOT SPECIFIED: DEFAULT INITIALIZATION TO ", nbVehicles, " VEHICLES");
 	}
 	else
 	{
 		if (verbose)
-			std::cout << "----- FLEET SIZE SPECIFIED: SET TO " << nbVehicles << " VEHICLES" << std::endl;
+			log("----- FLEET SIZE SPECIFIED: SET TO ", nbVehicles, " VEHICLES");
 	}
+}
+
+void Params::finalizeInitialization()
+{
+	// Safeguards to avoid possible numerical instability in case of instances containing arbitrarily small or large numerical values
+	if (maxDist < 0.1 || maxDist > 100000)
+		throw std::string(
+			"The distances are of very small or large scale. This could impact numerical stability. Please rescale the dataset and run again.");
+	if (maxDemand < 0.1 || maxDemand > 100000)
+		throw std::string(
+			"The demand quantities are of very small or large scale. This could impact numerical stability. Please rescale the dataset and run again.");
+	if (nbVehicles < std::ceil(totalDemand / vehicleCapacity))
+		throw std::string("Fleet size is insufficient to service the considered clients.");
+
+	// A reasonable scale for the initial values of the penalties
+	penaltyDuration = 1;
+	penaltyCapacity = std::max<double>(0.1, std::min<double>(1000., maxDist / maxDemand));
+
+	if (verbose)
+		log("----- INSTANCE SUCCESSFULLY LOADED WITH ", nbClients, " CLIENTS AND ", nbVehicles, " VEHICLES");
+}
+
+// The universal constructor for both executable and shared library
+// When the executable is run from the commandline,
+// it will first generate an CVRPLIB instance from .vrp file, then supply necessary information.
+Params::Params(
+	const std::vector<double>& x_coords,
+	const std::vector<double>& y_coords,
+	const std::vector<std::vector<double>>& dist_mtx,
+	const std::vector<double>& service_time,
+	const std::vector<double>& demands,
+	double vehicleCapacity,
+	double durationLimit,
+	int nbVeh,
+	bool isDurationConstraint,
+	bool verbose,
+	const AlgorithmParameters& ap,
+	std::function <void(const std::string &)> logSink
+)
+	: verbose(verbose), ap(ap), isDurationConstraint(isDurationConstraint), nbVehicles(nbVeh), durationLimit(durationLimit),
+	  vehicleCapacity(vehicleCapacity), savingsList(nullptr), nbSavings(0), logSink(logSink)
+{
+	reorderNodes(x_coords, y_coords, (int)dist_mtx.size());
+	fillDistances(dist_mtx, (int)dist_mtx.size());
+	preprocess(x_coords, y_coords, service_time, demands);
+}
+
+// Initialization from a prebuilt distance matrix, which is taken over when it is already in the internal numbering and storage layout
+Params::Params(
+	const std::vector<double>& x_coords,
+	const std::vector<double>& y_coords,
+	DistanceMatrix&& dist_mtx,
+	const std::vector<double>& service_time,
+	const std::vector<double>& demands,
+	double vehicleCapacity,
+	double durationLimit,
+	int nbVeh,
+	bool isDurationConstraint,
+	bool verbose,
+	const AlgorithmParameters& ap,
+	std::function <void(const std::string &)> logSink
+)
+	: verbose(verbose), ap(ap), isDurationConstraint(isDurationConstraint), nbVehicles(nbVeh), durationLimit(durationLimit),
+	  vehicleCapacity(vehicleCapacity), savingsList(nullptr), nbSavings(0), logSink(logSink)
+{
+	int nbNodes = dist_mtx.nbNodes();
+	reorderNodes(x_coords, y_coords, nbNodes);
+	bool isIdentity = true;
+	for (int i = 0; i < nbNodes && isIdentity; i++) isIdentity = (originalIndex[i] == i);
+	isSymmetric = isIdentity && (dist_mtx.isPacked() || isSymmetricMatrix(dist_mtx, nbNodes));
+	if (isIdentity && dist_mtx.isPacked() == isPackedStorage(nbNodes, isSymmetric, ap)) timeCost = std::move(dist_mtx);
+	else fillDistances(dist_mtx, nbNodes);
+	preprocess(x_coords, y_coords, service_time, demands);
+}
+
+void Params::preprocess(const std::vector<double>& x_coords, const std::vector<double>& y_coords, const std::vector<double>& service_time, const std::vector<double>& demands)
+{
+	initializeClients(x_coords, y_coords, service_time, demands);
 
 	// Calculation of the maximum distance
 	maxDist = 0.;
@@ -84,19 +235,21 @@ Params::Params(
 	// Calculation of the savings list (when the Clarke & Wright heuristic is used)
 	if (ap.randGeneration < 1.0)
 	{
-		savingsList = std::vector < Savings >(nbClients * (nbClients - 1) / 2);	// Assuming the distance matrix is symmetric
+		savingsStorage = std::vector < Savings >(nbClients * (nbClients - 1) / 2);	// Assuming the distance matrix is symmetric
 		
 		int savingsCount = 0;
 		for (int i = 1; i <= nbClients; i++)
 			for (int j = 1; j < i; j++)
 			{
-				savingsList[savingsCount].c1 = i;
-				savingsList[savingsCount].c2 = j;
-				savingsList[savingsCount].value = timeCost[0][i] + timeCost[0][j] - timeCost[i][j];
+				savingsStorage[savingsCount].c1 = i;
+				savingsStorage[savingsCount].c2 = j;
+				savingsStorage[savingsCount].value = timeCost[0][i] + timeCost[0][j] - timeCost[i][j];
 				savingsCount++;
 			}
 
-		std::sort(savingsList.begin(), savingsList.end(), compSavings);
+		std::sort(savingsStorage.begin(), savingsStorage.end(), compSavings);
+		savingsList = savingsStorage.data();
+		nbSavings = (int)savingsStorage.size();
 	}
 
 	// Calculation of the correlated vertices for each customer (for the granular restriction)
@@ -123,22 +276,22 @@ Params::Params(
 		for (int x : setCorrelatedVertices[i])
 			correlatedVertices[i].push_back(x);
 
-	// Safeguards to avoid possible numerical instability in case of instances containing arbitrarily small or large numerical values
-	if (maxDist < 0.1 || maxDist > 100000)
-		throw std::string(
-			"The distances are of very small or large scale. This could impact numerical stability. Please rescale the dataset and run again.");
-	if (maxDemand < 0.1 || maxDemand > 100000)
-		throw std::string(
-			"The demand quantities are of very small or large scale. This could impact numerical stability. Please rescale the dataset and run again.");
-	if (nbVehicles < std::ceil(totalDemand / vehicleCapacity))
-		throw std::string("Fleet size is insufficient to service the considered clients.");
-
-	// A reasonable scale for the initial values of the penalties
-	penaltyDuration = 1;
-	penaltyCapacity = std::max<double>(0.1, std::min<double>(1000., maxDist / maxDemand));
-
-	if (verbose)
-		std::cout << "----- INSTANCE SUCCESSFULLY LOADED WITH " << nbClients << " CLIENTS AND " << nbVehicles << " VEHICLES" << std::endl;
+	finalizeInitialization();
 }
 
+// Initialization from an instance cache: the distance matrix and the savings list are views on the cached data, and the preprocessing is skipped
+Params::Params(std::shared_ptr < const InstanceCache > cache, int nbVeh, bool verbose, const AlgorithmParameters& ap, std::function <void(const std::string &)> logSink)
+	: verbose(verbose), ap(ap), isDurationConstraint(cache->isDurationConstraint), isSymmetric(cache->isSymmetric), nbVehicles(nbVeh), durationLimit(cache->durationLimit),
+	  vehicleCapacity(cache->vehicleCapacity), maxDist(cache->maxDist), originalIndex(cache->originalIndex, cache->originalIndex + cache->nbNodes),
+	  timeCost(cache->nbNodes, cache->isPacked, cache->distances), savingsList(cache->savings), nbSavings(cache->nbSavings), instanceCache(cache), logSink(logSink)
+{
+	int nbNodes = cache->nbNodes;
+	initializeClients(std::vector<double>(cache->x_coords, cache->x_coords + nbNodes), std::vector<double>(cache->y_coords, cache->y_coords + nbNodes),
+		std::vector<double>(cache->service_time, cache->service_time + nbNodes), std::vector<double>(cache->demands, cache->demands + nbNodes));
+
+	correlatedVertices = std::vector<std::vector<int> >(nbNodes);
+	for (int i = 0; i < nbNodes; i++)
+		correlatedVertices[i] = std::vector<int>(cache->neighbors + cache->neighborOffsets[i], cache->neighbors + cache->neighborOffsets[i + 1]);
 
+	finalizeInitialization();
+}
@@ -25,6 +25,9 @@ SOFTWARE.*/
 
 #include "CircleSector.h"
 #include "AlgorithmParameters.h"
+#include "DistanceMatrix.h"
+#include "InstanceCache.h"
+#include "Trace.h"
 #include <string>
 #include <vector>
 #include <list>
@@ -38,6 +41,9 @@ SOFTWARE.*/
 #include <algorithm>
 #include <unordered_set>
 #include <random>
+#include <chrono>
+#include <memory>
+#include <functional>
 #define MY_EPSILON 0.00001 // Precision parameter, used to avoid numerical instabilities
 #define PI 3.14159265359
 
@@ -70,13 +76,21 @@ public:
 	double penaltyDuration;				// Penalty for one unit of duration excess (adapted through the search)
 
 	/* START TIME OF THE ALGORITHM */
-	clock_t startTime;                  // Start time of the optimization (set when Params is constructed)
+	std::chrono::steady_clock::time_point startTime;	// Start time of the optimization (set when Params is constructed)
+
+	// Returns the time elapsed since the start of the optimization, in seconds
+	// Wall-clock time is used, since the CPU time of the process accumulates over all the threads of the search
+	double getElapsedTime() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count(); }
+
+	// Moves the start time so that the elapsed time equals the given value (used when resuming a search from a checkpoint)
+	void setElapsedTime(double elapsedTime) { startTime = std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(elapsedTime)); }
 
 	/* RANDOM NUMBER GENERATOR */       
 	std::minstd_rand ran;               // Using the fastest and simplest LCG. The quality of random numbers is not critical for the LS, but speed is
 
 	/* DATA OF THE PROBLEM INSTANCE */
 	bool isDurationConstraint ;								// Indicates if the problem includes duration constraints
+	bool isSymmetric ;										// Indicates if the distance matrix is symmetric
 	int nbClients ;											// Number of clients (excluding the depot)
 	int nbVehicles ;										// Number of vehicles
 	double durationLimit;									// Route duration limit
@@ -85,10 +99,28 @@ public:
 	double maxDemand;										// Maximum demand of a client
 	double maxDist;											// Maximum distance between two clients
 	std::vector< Client > cli ;								// Vector containing information on each client
-	const std::vector< std::vector< double > >& timeCost;	// Distance matrix
+	std::vector< int > originalIndex;						// For each node, its index in the input data (differs from the identity only when a spatial ordering is used)
+	DistanceMatrix timeCost;								// Distance matrix (in the internal numbering of the nodes)
 	std::vector< std::vector< int > > correlatedVertices;	// Neighborhood restrictions: For each client, list of nearby customers
 	bool areCoordinatesProvided;                            // Check if valid coordinates are provided
-	std::vector < Savings > savingsList;					// Savings list used in the Clarke & Wright heuristic
+	const Savings * savingsList;							// Savings list used in the Clarke & Wright heuristic (in savingsStorage or in the instance cache)
+	int nbSavings;											// Size of the savings list
+	std::vector < Savings > savingsStorage;					// Savings list, when it is computed by Params
+	std::shared_ptr < const InstanceCache > instanceCache;	// Instance cache from which the preprocessed data is read (if any)
+
+	/* LOG OF THE SEARCH */
+	std::function <void(const std::string &)> logSink;		// Receives each line of the log (the lines are written on the standard output if not set)
+
+	// Writes a line of the log, made of the given values (the verbose level is checked by the caller)
+	template <typename... Values> void log(const Values &... values) const
+	{
+		std::ostringstream line;
+		(line << ... << values);
+		writeLog(line.str());
+	}
+
+	/* TRACE OF THE PHASES OF THE SEARCH (OPTIONAL) */
+	std::unique_ptr < Trace > trace;						// Receives the spans of the main phases of the search, if set
 
 	// Initialization from a given data set
 	Params(const std::vector<double>& x_coords,
@@ -101,7 +133,50 @@ public:
 		int nbVeh,
 		bool isDurationConstraint,
 		bool verbose,
-		const AlgorithmParameters& ap);
+		const AlgorithmParameters& ap,
+		std::function <void(const std::string &)> logSink = nullptr);
+
+	// Initialization from a prebuilt distance matrix (e.g., DistanceMatrix::buildEuclidean, or a view on the matrix of the caller), which avoids a copy of the matrix when no spatial ordering is used
+	// The matrix should be in the layout given by isPackedStorage: it is then taken over by Params (a view must outlive Params), otherwise it is copied in the internal numbering and layout
+	Params(const std::vector<double>& x_coords,
+		const std::vector<double>& y_coords,
+		DistanceMatrix&& dist_mtx,
+		const std::vector<double>& service_time,
+		const std::vector<double>& demands,
+		double vehicleCapacity,
+		double durationLimit,
+		int nbVeh,
+		bool isDurationConstraint,
+		bool verbose,
+		const AlgorithmParameters& ap,
+		std::function <void(const std::string &)> logSink = nullptr);
+
+	// Initialization from an instance cache, which holds the data set along with the distance matrix, savings list and granular neighborhoods
+	Params(std::shared_ptr < const InstanceCache > cache, int nbVeh, bool verbose, const AlgorithmParameters& ap, std::function <void(const std::string &)> logSink = nullptr);
+
+	// Tells whether a distance matrix with the given size and symmetry is stored as a packed triangle
+	static bool isPackedStorage(int nbNodes, bool isSymmetric, const AlgorithmParameters& ap);
+
+private:
+
+	// Sends a line of the log to the sink, or writes it on the standard output
+	void writeLog(const std::string & line) const;
+
+	// Computes the internal numbering of the nodes (originalIndex)
+	// When a spatial ordering is requested, the clients are sorted along a Morton or Hilbert curve so that nearby clients get nearby indices
+	void reorderNodes(const std::vector<double>& x_coords, const std::vector<double>& y_coords, int nbNodes);
+
+	// Fills the distance matrix expressed in the internal numbering, from a matrix in the input numbering (std::vector rows or DistanceMatrix)
+	template <typename Matrix> void fillDistances(const Matrix& dist_mtx, int nbNodes);
+
+	// Initializes the clients, then computes the maximum distance, the savings list and the granular neighborhoods from the distance matrix
+	void preprocess(const std::vector<double>& x_coords, const std::vector<double>& y_coords, const std::vector<double>& service_time, const std::vector<double>& demands);
+
+	// Initializes the data of the clients (in the internal numbering) and the fleet size
+	void initializeClients(const std::vector<double>& x_coords, const std::vector<double>& y_coords, const std::vector<double>& service_time, const std::vector<double>& demands);
+
+	// Checks the scale of the data and initializes the penalties
+	void finalizeInitialization();
 };
 #endif
 
@@ -0,0 +1,139 @@
+#include "PatternMiner.h"
+
+#include <algorithm>
+#include <bitset>
+
+std::vector< std::vector < std::vector <int> > > PatternMiner::mine(const std::vector < std::vector < std::vector <int> > > & eliteRoutes, int minSup, int numPatterns, int nbNodes)
+{
+	std::vector< std::vector < std::vector <int> > > patterns;
+	if ((int)eliteRoutes.size() < minSup || numPatterns <= 0) return patterns;
+
+	PatternMiner miner((int)eliteRoutes.size(), minSup);
+	miner.collectEdges(eliteRoutes, nbNodes);
+	miner.closeTidsets();
+
+	// The maximal frequent edge sets correspond to the minimal frequent closed tidsets
+	std::vector < std::pair <int, const Tidset *> > maximalSets; // (number of edges, tidset)
+	for (const Tidset & tidset : miner.closedTidsets)
+	{
+		bool isMinimal = true;
+		for (const Tidset & other : miner.closedTidsets)
+			if (&other != &tidset && miner.isSubset(other.data(), tidset.data())) { isMinimal = false; break; }
+		if (!isMinimal) continue;
+
+		int nbEdges = 0;
+		for (int e = 0; e < (int)miner.edgeFrom.size(); e++)
+			if (miner.isSubset(tidset.data(), &miner.edgeTidsets[e * miner.nbWords])) nbEdges++;
+		maximalSets.push_back({ nbEdges, &tidset });
+	}
+
+	// Keeping the largest ones
+	std::stable_sort(maximalSets.begin(), maximalSets.end(), [](const std::pair <int, const Tidset *> & a, const std::pair <int, const Tidset *> & b) { return a.first > b.first; });
+	if ((int)maximalSets.size() > numPatterns) maximalSets.resize(numPatterns);
+
+	std::vector <int> succ(nbNodes, -1);
+	std::vector <int> pred(nbNodes, -1);
+	for (const std::pair <int, const Tidset *> & maximalSet : maximalSets)
+		patterns.push_back(miner.buildPattern(*maximalSet.second, succ, pred));
+	return patterns;
+}
+
+int PatternMiner::support(const uint64_t * tidset) const
+{
+	int count = 0;
+	for (int w = 0; w < nbWords; w++) count += (int)std::bitset<64>(tidset[w]).count();
+	return count;
+}
+
+bool PatternMiner::isSubset(const uint64_t * a, const uint64_t * b) const
+{
+	for (int w = 0; w < nbWords; w++)
+		if (a[w] & ~b[w]) return false;
+	return true;
+}
+
+void PatternMiner::collectEdges(const std::vector < std::vector < std::vector <int> > > & eliteRoutes, int nbNodes)
+{
+	// Each client has a single successor per solution, hence at most one edge per solution leaving each node
+	std::vector < std::vector <int> > edgesLeaving(nbNodes);
+	for (int s = 0; s < (int)eliteRoutes.size(); s++)
+		for (const std::vector <int> & route : eliteRoutes[s])
+			for (int c = 0; c < (int)route.size() - 1; c++)
+			{
+				int n1 = route[c];
+				int n2 = route[c + 1];
+				int edge = -1;
+				for (int e : edgesLeaving[n1])
+					if (edgeTo[e] == n2) { edge = e; break; }
+				if (edge == -1)
+				{
+					edge = (int)edgeFrom.size();
+					edgesLeaving[n1].push_back(edge);
+					edgeFrom.push_back(n1);
+					edgeTo.push_back(n2);
+					edgeTidsets.resize(edgeTidsets.size() + nbWords, 0);
+				}
+				edgeTidsets[edge * nbWords + s / 64] |= (uint64_t)1 << (s % 64);
+			}
+
+	// Only the frequent edges are kept
+	int nbFrequent = 0;
+	for (int e = 0; e < (int)edgeFrom.size(); e++)
+	{
+		if (support(&edgeTidsets[e * nbWords]) < minSup) continue;
+		edgeFrom[nbFrequent] = edgeFrom[e];
+		edgeTo[nbFrequent] = edgeTo[e];
+		std::copy(edgeTidsets.begin() + e * nbWords, edgeTidsets.begin() + (e + 1) * nbWords, edgeTidsets.begin() + nbFrequent * nbWords);
+		generators.insert(Tidset(edgeTidsets.begin() + e * nbWords, edgeTidsets.begin() + (e + 1) * nbWords));
+		nbFrequent++;
+	}
+	edgeFrom.resize(nbFrequent);
+	edgeTo.resize(nbFrequent);
+	edgeTidsets.resize(nbFrequent * nbWords);
+}
+
+void PatternMiner::closeTidsets()
+{
+	closedTidsets = generators;
+	std::vector <Tidset> toExpand(generators.begin(), generators.end());
+	Tidset intersection(nbWords);
+	while (!toExpand.empty())
+	{
+		Tidset tidset = toExpand.back();
+		toExpand.pop_back();
+		for (const Tidset & generator : generators)
+		{
+			for (int w = 0; w < nbWords; w++) intersection[w] = tidset[w] & generator[w];
+			if (support(intersection.data()) >= minSup && closedTidsets.insert(intersection).second)
+				toExpand.push_back(intersection);
+		}
+	}
+}
+
+std::vector < std::vector <int> > PatternMiner::buildPattern(const Tidset & tidset, std::vector <int> & succ, std::vector <int> & pred) const
+{
+	std::vector <int> origins;
+	for (int e = 0; e < (int)edgeFrom.size(); e++)
+		if (isSubset(tidset.data(), &edgeTidsets[e * nbWords]))
+		{
+			succ[edgeFrom[e]] = edgeTo[e];
+			pred[edgeTo[e]] = edgeFrom[e];
+			origins.push_back(edgeFrom[e]);
+		}
+
+	// Each fragment starts at an origin without predecessor (the edges come from paths, so there are no cycles)
+	std::sort(origins.begin(), origins.end());
+	std::vector < std::vector <int> > pattern;
+	for (int node : origins)
+		if (pred[node] == -1)
+		{
+			std::vector <int> fragment(1, node);
+			for (int next = succ[node]; next != -1; next = succ[next]) fragment.push_back(next);
+			pattern.push_back(fragment);
+		}
+
+	for (int node : origins) { pred[succ[node]] = -1; succ[node] = -1; }
+	return pattern;
+}
+
+PatternMiner::PatternMiner(int nbSolutions, int minSup) : nbWords((nbSolutions + 63) / 64), minSup(minSup) {}
@@ -0,0 +1,50 @@
+#ifndef PATTERNMINER_H
+#define PATTERNMINER_H
+
+#include <vector>
+#include <set>
+#include <cstdint>
+
+// Bitset over the solutions of the elite set (bit i is set if solution i contains the edge)
+typedef std::vector <uint64_t> Tidset;
+
+// Miner of the maximal frequent edge sets of a (small) set of elite solutions.
+// Each edge between consecutive clients is represented by its tidset, so that the support of an edge set is the popcount of the intersection of the tidsets.
+// The maximal frequent edge sets are in bijection with the minimal frequent closed tidsets, which are obtained by closing the distinct tidsets of the frequent edges under intersection.
+class PatternMiner
+{
+public:
+
+	// Returns the numPatterns largest maximal edge sets contained in at least minSup of the elite solutions, reconstructed as route fragments
+	static std::vector< std::vector < std::vector <int> > > mine(const std::vector < std::vector < std::vector <int> > > & eliteRoutes, int minSup, int numPatterns, int nbNodes);
+
+private:
+
+	int nbWords;								// Number of 64-bit words of a tidset
+	int minSup;									// Minimum support of an edge set
+	std::vector <int> edgeFrom;					// Origin of each distinct edge of the elite solutions
+	std::vector <int> edgeTo;					// Destination of each distinct edge of the elite solutions
+	std::vector <uint64_t> edgeTidsets;			// Tidsets of the edges, stored contiguously (nbWords words per edge)
+	std::set <Tidset> generators;				// Distinct tidsets of the frequent edges
+	std::set <Tidset> closedTidsets;			// Frequent closed tidsets
+
+	// Number of solutions in a tidset
+	int support(const uint64_t * tidset) const;
+
+	// Tells whether tidset a is a subset of tidset b
+	bool isSubset(const uint64_t * a, const uint64_t * b) const;
+
+	// Registers the edges of the elite solutions along with their tidsets
+	void collectEdges(const std::vector < std::vector < std::vector <int> > > & eliteRoutes, int nbNodes);
+
+	// Closes the tidsets of the frequent edges under intersection (keeping only the frequent ones)
+	void closeTidsets();
+
+	// Builds the route fragments formed by the edges whose tidset contains the given tidset
+	std::vector < std::vector <int> > buildPattern(const Tidset & tidset, std::vector <int> & succ, std::vector <int> & pred) const;
+
+	// Constructor
+	PatternMiner(int nbSolutions, int minSup);
+};
+
+#endif
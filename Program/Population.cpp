@@ -1,13 +1,13 @@
-#include "fpmax.h"
-
 #include "Population.h"
+#include "PatternMiner.h"
 
 void Population::generatePopulation()
 {
-	if (params.verbose) std::cout << "----- BUILDING INITIAL POPULATION" << std::endl;
+	TraceSpan span(params.trace.get(), "generatePopulation");
+	if (params.verbose) params.log("----- BUILDING INITIAL POPULATION");
 	
 	// A randomized version of the Clarke & Wright savings heuristic is used to generate better individuals faster
-	for (int i = 0; i < params.ap.mu * (1.0 - params.ap.randGeneration) && (i == 0 || params.ap.timeLimit == 0 || (double)(clock() - params.startTime) / (double)CLOCKS_PER_SEC < params.ap.timeLimit) ; i++)
+	for (int i = 0; i < params.ap.mu * (1.0 - params.ap.randGeneration) && (i == 0 || ((params.ap.timeLimit == 0 || params.getElapsedTime() < params.ap.timeLimit) && !isStopRequested)) ; i++)
 	{
 		Individual indiv(params, true, nextMDMPattern());
 		localSearch.run(indiv, params.penaltyCapacity, params.penaltyDuration);
@@ -15,7 +15,7 @@ void Population::generatePopulation()
 	}
 
 	// Another part is ramdomly generated to keep diversity
-	for (int i = 0; i < params.ap.mu * params.ap.randGeneration && (i == 0 || params.ap.timeLimit == 0 || (double)(clock() - params.startTime) / (double)CLOCKS_PER_SEC < params.ap.timeLimit) ; i++)
+	for (int i = 0; i < params.ap.mu * params.ap.randGeneration && (i == 0 || ((params.ap.timeLimit == 0 || params.getElapsedTime() < params.ap.timeLimit) && !isStopRequested)) ; i++)
 	{
 		Individual randomIndiv(params);
 		split.generalSplit(randomIndiv, params.nbVehicles);
@@ -31,6 +31,7 @@ void Population::generatePopulation()
 
 bool Population::addIndividual(const Individual & indiv, bool updateFeasible)
 {
+	TraceSpan span(params.trace.get(), "addIndividual");
 	if (updateFeasible)
 	{
 		listFeasibilityLoad.push_back(indiv.eval.capacityExcess < MY_EPSILON);
@@ -46,7 +47,7 @@ bool Population::addIndividual(const Individual & indiv, bool updateFeasible)
 	Individual * myIndividual = new Individual(indiv);
 	for (Individual * myIndividual2 : subpop)
 	{
-		double myDistance = brokenPairsDistance(*myIndividual,*myIndividual2);
+		double myDistance = (myIndividual->edgeHash == myIndividual2->edgeHash) ? 0. : brokenPairsDistance(*myIndividual,*myIndividual2); // Clones are at distance 0
 		myIndividual2->indivsPerProximity.insert({ myDistance, myIndividual });
 		myIndividual->indivsPerProximity.insert({ myDistance, myIndividual2 });
 	}
@@ -58,8 +59,7 @@ bool Population::addIndividual(const Individual & indiv, bool updateFeasible)
 
 	// Trigger a survivor selection if the maximimum subpopulation size is exceeded
 	if ((int)subpop.size() > params.ap.mu + params.ap.lambda)
-		while ((int)subpop.size() > params.ap.mu)
-			removeWorstBiasedFitness(subpop);
+		survivorsSelection(subpop);
 
 	// Track best solution
 	if (indiv.eval.isFeasible && indiv.eval.penalizedCost < bestSolutionRestart.eval.penalizedCost - MY_EPSILON)
@@ -69,7 +69,8 @@ bool Population::addIndividual(const Individual & indiv, bool updateFeasible)
 		if (indiv.eval.penalizedCost < bestSolutionOverall.eval.penalizedCost - MY_EPSILON)
 		{
 			bestSolutionOverall = indiv;
-			searchProgress.push_back({ clock() - params.startTime , bestSolutionOverall.eval.penalizedCost });
+			searchProgress.push_back({ params.getElapsedTime() , bestSolutionOverall.eval.penalizedCost });
+			if (newBestCallback && newBestCallback(bestSolutionOverall)) isStopRequested = true;
 		}
 		return true;
 	}
@@ -102,40 +103,125 @@ void Population::updateBiasedFitnesses(SubPopulation & pop)
 	}
 }
 
-void Population::removeWorstBiasedFitness(SubPopulation & pop)
+void Population::survivorsSelection(SubPopulation & pop)
 {
-	updateBiasedFitnesses(pop);
-	if (pop.size() <= 1) throw std::string("Eliminating the best individual: this should not occur in HGS");
-
-	Individual * worstIndividual = NULL;
-	int worstIndividualPosition = -1;
-	bool isWorstIndividualClone = false;
-	double worstIndividualBiasedFitness = -1.e30;
-	for (int i = 1; i < (int)pop.size(); i++)
+	// Same selection as removing the worst individual in terms of biased fitness (preferably a clone) until mu individuals remain
+	// The diversity contributions are updated incrementally after each removal, and the proximity structures are purged once at the end
+	int popSize = (int)pop.size();
+	std::unordered_map <Individual *, int> position;
+	for (int i = 0; i < popSize; i++) position[pop[i]] = i;
+
+	std::vector < std::vector <double> > distance(popSize, std::vector <double>(popSize, 0.));
+	for (int i = 0; i < popSize; i++)
+		for (const std::pair <double, Individual *> & neighbor : pop[i]->indivsPerProximity)
+			distance[i][position[neighbor.second]] = neighbor.first;
+
+	std::unordered_map <uint64_t, int> nbIndividualsPerHash;	// Clones are identified by their edge hash
+	for (Individual * indiv : pop) nbIndividualsPerHash[indiv->edgeHash]++;
+
+	// Average distance to the nbClose closest individuals still in the population (lastCounted is the largest of these distances)
+	std::vector <bool> isRemoved(popSize, false);
+	std::vector <double> diversity(popSize);
+	std::vector <double> lastCounted(popSize);
+	int nbAlive = popSize;
+	auto updateDiversity = [&](int i)
+	{
+		int maxSize = std::min<int>(params.ap.nbClose, nbAlive - 1);
+		double result = 0.;
+		int count = 0;
+		for (auto it = pop[i]->indivsPerProximity.begin(); count < maxSize; ++it)
+		{
+			if (isRemoved[position[it->second]]) continue;
+			result += it->first;
+			lastCounted[i] = it->first;
+			count++;
+		}
+		diversity[i] = result / (double)maxSize;
+	};
+	for (int i = 0; i < popSize; i++) updateDiversity(i);
+
+	std::vector <int> alive(popSize); // Indices of the remaining individuals, by increasing penalized cost
+	for (int i = 0; i < popSize; i++) alive[i] = i;
+	std::vector <std::pair <double, int> > ranking;
+	while (nbAlive > params.ap.mu)
 	{
-		bool isClone = (averageBrokenPairsDistanceClosest(*pop[i],1) < MY_EPSILON); // A distance equal to 0 indicates that a clone exists
-		if ((isClone && !isWorstIndividualClone) || (isClone == isWorstIndividualClone && pop[i]->biasedFitness > worstIndividualBiasedFitness))
+		// Biased fitnesses of the remaining individuals
+		ranking.clear();
+		for (int i = 0; i < nbAlive; i++) ranking.push_back({ -diversity[alive[i]], i });
+		std::sort(ranking.begin(), ranking.end());
+		for (int i = 0; i < nbAlive; i++)
 		{
-			worstIndividualBiasedFitness = pop[i]->biasedFitness;
-			isWorstIndividualClone = isClone;
-			worstIndividualPosition = i;
-			worstIndividual = pop[i];
+			double divRank = (double)i / (double)(nbAlive - 1);
+			double fitRank = (double)ranking[i].second / (double)(nbAlive - 1);
+			if (nbAlive <= params.ap.nbElite)
+				pop[alive[ranking[i].second]]->biasedFitness = fitRank;
+			else
+				pop[alive[ranking[i].second]]->biasedFitness = fitRank + (1.0 - (double)params.ap.nbElite / (double)nbAlive) * divRank;
+		}
+		if (nbAlive <= 1) throw std::string("Eliminating the best individual: this should not occur in HGS");
+
+		// Selecting the worst individual (the best one is never removed)
+		int worstIndividualPosition = -1;
+		bool isWorstIndividualClone = false;
+		double worstIndividualBiasedFitness = -1.e30;
+		for (int i = 1; i < nbAlive; i++)
+		{
+			Individual * indiv = pop[alive[i]];
+			bool isClone = (nbIndividualsPerHash[indiv->edgeHash] > 1);
+			if ((isClone && !isWorstIndividualClone) || (isClone == isWorstIndividualClone && indiv->biasedFitness > worstIndividualBiasedFitness))
+			{
+				worstIndividualBiasedFitness = indiv->biasedFitness;
+				isWorstIndividualClone = isClone;
+				worstIndividualPosition = i;
+			}
 		}
+
+		// Removing it, and updating the diversity contributions in which it was counted
+		int worst = alive[worstIndividualPosition];
+		alive.erase(alive.begin() + worstIndividualPosition);
+		isRemoved[worst] = true;
+		nbIndividualsPerHash[pop[worst]->edgeHash]--;
+		nbAlive--;
+		for (int i : alive)
+			if (nbAlive - 1 < params.ap.nbClose || distance[i][worst] <= lastCounted[i]) updateDiversity(i);
 	}
 
-	// Removing the individual from the population and freeing memory
-	pop.erase(pop.begin() + worstIndividualPosition); 
+	// Cleaning the distances to the removed individuals in the proximity structures, and freeing memory
+	for (int i : alive)
+		for (auto it = pop[i]->indivsPerProximity.begin(); it != pop[i]->indivsPerProximity.end();)
+		{
+			if (isRemoved[position[it->second]]) it = pop[i]->indivsPerProximity.erase(it);
+			else ++it;
+		}
+	for (int i = 0; i < popSize; i++)
+		if (isRemoved[i]) delete pop[i];
+	SubPopulation survivors;
+	for (int i : alive) survivors.push_back(pop[i]);
+	pop = survivors;
+}
 
-	// Cleaning its distances from the other individuals in the population
-	for (Individual * indiv2 : pop)
+void Population::addInitialSolution(const std::vector < std::vector <int> > & routes, bool seedMDMElite)
+{
+	// Translating the clients to the internal numbering
+	std::vector <int> internalIndex(params.nbClients + 1, -1);
+	for (int i = 0; i <= params.nbClients; i++) internalIndex[params.originalIndex[i]] = i;
+	std::vector < std::vector <int> > internalRoutes;
+	for (const std::vector <int> & route : routes)
 	{
-		auto it = indiv2->indivsPerProximity.begin();
-		while (it->second != worstIndividual) ++it;
-		indiv2->indivsPerProximity.erase(it);
+		internalRoutes.push_back(std::vector <int>());
+		for (int client : route)
+			internalRoutes.back().push_back((client >= 0 && client <= params.nbClients) ? internalIndex[client] : -1);
 	}
 
-	// Freeing memory
-	delete worstIndividual; 
+	Individual indiv(params, internalRoutes);
+	localSearch.run(indiv, params.penaltyCapacity, params.penaltyDuration);
+	addIndividual(indiv, true);
+	if (!indiv.eval.isFeasible)
+	{
+		localSearch.run(indiv, params.penaltyCapacity*10., params.penaltyDuration*10.);
+		if (indiv.eval.isFeasible) addIndividual(indiv, false);
+	}
+	if (seedMDMElite && indiv.eval.isFeasible) updateMDMElite(indiv);
 }
 
 // Inserts the individual in MDM elite set if: 
@@ -162,105 +248,64 @@ void Population::updateMDMElite(const Individual & indiv)
 	}
 }
 
-void Population::mineElite()
+bool Population::mineElite()
 {
+	TraceSpan span(params.trace.get(), "mineElite");
 	if (mdmEliteUpdated && mdmEliteNonUpdatingRestarts >= mdmEliteMaxNonUpdatingRestarts && mdmElite.size() > 1)
 	{
-		if (params.verbose) std::cout << "----- MINING PATTERNS FROM MDM ELITE SET" << std::endl;
-		
-		int minSup = std::max(2, (int) (params.ap.mdmMinSup * mdmElite.size()));
-		int numPatterns = params.ap.mdmNbPatterns;
+		// Only one mining task at a time: if the previous one is still running, the elite set will be mined at a later restart
+		if (mdmMiningResult.valid()) return false;
 
-		int nbNodes = params.nbClients + 1; // all clients + depot
+		if (params.verbose) params.log("----- MINING PATTERNS FROM MDM ELITE SET");
 
-		Dataset* dataset = new Dataset;
+		// Snapshot of the routes of the elite set, so that the mining does not depend on later updates of the set
+		std::vector < std::vector < std::vector <int> > > eliteRoutes;
 		for (auto it = mdmElite.begin(); it != mdmElite.end(); ++it)
-		{
-			Individual indiv = *it;
-			std::set<int> transaction;
-			for (int r = 0; r < params.nbVehicles; r++)
-				for (int c = 0; c < (int) indiv.chromR[r].size() - 1; c++)
-				{
-					int index = indiv.chromR[r][c] * nbNodes + indiv.chromR[r][c + 1]; // maps 2D matrix cell indices to vector index
-					transaction.insert(index);
-				}
-			dataset->push_back(transaction);
-		}
+			eliteRoutes.push_back(it->chromR);
 
-		FISet* frequentItemsets = fpmax(dataset, minSup, numPatterns);
+		int minSup = std::max(2, (int) (params.ap.mdmMinSup * mdmElite.size()));
+		int numPatterns = params.ap.mdmNbPatterns;
+		int nbNodes = params.nbClients + 1; // all clients + depot
 
-		mdmPatterns.clear();
-		for (FISet::iterator it=frequentItemsets->begin(); it!=frequentItemsets->end(); ++it)
+		if (params.ap.mdmBackgroundMining)
+			mdmMiningResult = std::async(std::launch::async, &PatternMiner::mine, std::move(eliteRoutes), minSup, numPatterns, nbNodes);
+		else
 		{
-			std::vector < std::vector <int> > tempPattern;
-			std::list<std::vector <int>*> routes;
-
-			for (std::set<int>::iterator it2=it->begin(); it2!=it->end(); ++it2)
-			{
-				unsigned index = *it2;
-
-				int n1 = index / nbNodes;
-				int n2 = index % nbNodes;
-
-				std::vector <int> *lhs = NULL;
-				std::vector <int> *rhs = NULL;
-				std::vector <int> *tempRoute;
-				for (std::list<std::vector <int>*>::iterator r = routes.begin(); r != routes.end(); r++)
-					if (n1 && n1 == (*r)->back())
-						lhs = *r;
-					else if (n2 && n2 == (*r)->front())
-						rhs = *r;
-				if (lhs)
-					if (rhs)
-					{
-						for (std::vector<int>::iterator n = rhs->begin(); n != rhs->end(); n++)
-							lhs->push_back(*n);
-						routes.remove(rhs);
-						delete rhs;
-					}
-					else
-						lhs->push_back(n2);
-				else if (rhs)
-					rhs->insert(rhs->begin(), n1);
-				else
-				{
-					tempRoute = new std::vector <int>;
-					tempRoute->push_back(n1);
-					tempRoute->push_back(n2);
-					routes.push_back(tempRoute);
-				}
-			}
-
-			for (std::list<std::vector <int>*>::iterator r = routes.begin(); r != routes.end(); r++)
-				tempPattern.push_back(**r);
-
-			mdmPatterns.push_back(tempPattern);
+			mdmPatterns = PatternMiner::mine(eliteRoutes, minSup, numPatterns, nbNodes);
+			mdmNextPattern = 0;
 		}
-		
-		delete dataset;
-		delete frequentItemsets;
 
 		mdmEliteUpdated = false;
-		mdmNextPattern = 0;
+		return true;
 	}
+	return false;
 }
 
 std::vector < std::vector <int> >* Population::nextMDMPattern()
 {
+	// Swaps in the patterns mined in background as soon as they are available
+	if (mdmMiningResult.valid() && mdmMiningResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		mdmPatterns = mdmMiningResult.get();
+		mdmNextPattern = 0;
+	}
+
 	if (mdmPatterns.empty())
 		return NULL;
 	
 	std::vector < std::vector <int> >* pattern = &(mdmPatterns[mdmNextPattern]);
 	mdmNextPattern = (mdmNextPattern + 1) % mdmPatterns.size();
+	mdmPatternUses++;
 
 	return pattern;
 }
 
 void Population::restart()
 {
+	TraceSpan span(params.trace.get(), "restart");
 	mdmEliteNonUpdatingRestarts++;
 	
-	if (params.verbose) std::cout << "----- RESET: CREATING A NEW POPULATION -----" << std::endl;
+	if (params.verbose) params.log("----- RESET: CREATING A NEW POPULATION -----");
 	for (Individual * indiv : feasibleSubpop) delete indiv ;
 	for (Individual * indiv : infeasibleSubpop) delete indiv;
 	feasibleSubpop.clear();
@@ -271,6 +316,7 @@ void Population::restart()
 
 void Population::managePenalties()
 {
+	TraceSpan span(params.trace.get(), "managePenalties");
 	// Setting some bounds [0.1,100000] to the penalty values for safety
 	double fractionFeasibleLoad = (double)std::count(listFeasibilityLoad.begin(), listFeasibilityLoad.end(), true) / (double)listFeasibilityLoad.size();
 	if (fractionFeasibleLoad < params.ap.targetFeasible - 0.05 && params.penaltyCapacity < 100000.) params.penaltyCapacity = std::min<double>(params.penaltyCapacity * 1.2,100000.);
@@ -340,19 +386,41 @@ void Population::printState(int nbIter, int nbIterNoImprovement)
 {
 	if (params.verbose)
 	{
-		std::printf("It %6d %6d | T(s) %.2f", nbIter, nbIterNoImprovement, (double)(clock()-params.startTime)/(double)CLOCKS_PER_SEC);
+		// The line is formatted in a buffer, and written at once in the log
+		char line[512];
+		int length = std::snprintf(line, sizeof(line), "It %6d %6d | T(s) %.2f", nbIter, nbIterNoImprovement, params.getElapsedTime());
+
+		if (getBestFeasible() != NULL) length += std::snprintf(line + length, sizeof(line) - length, " | Feas %zu %.2f %.2f", feasibleSubpop.size(), getBestFeasible()->eval.penalizedCost, getAverageCost(feasibleSubpop));
+		else length += std::snprintf(line + length, sizeof(line) - length, " | NO-FEASIBLE");
 
-		if (getBestFeasible() != NULL) std::printf(" | Feas %zu %.2f %.2f", feasibleSubpop.size(), getBestFeasible()->eval.penalizedCost, getAverageCost(feasibleSubpop));
-		else std::printf(" | NO-FEASIBLE");
+		if (getBestInfeasible() != NULL) length += std::snprintf(line + length, sizeof(line) - length, " | Inf %zu %.2f %.2f", infeasibleSubpop.size(), getBestInfeasible()->eval.penalizedCost, getAverageCost(infeasibleSubpop));
+		else length += std::snprintf(line + length, sizeof(line) - length, " | NO-INFEASIBLE");
 
-		if (getBestInfeasible() != NULL) std::printf(" | Inf %zu %.2f %.2f", infeasibleSubpop.size(), getBestInfeasible()->eval.penalizedCost, getAverageCost(infeasibleSubpop));
-		else std::printf(" | NO-INFEASIBLE");
+		length += std::snprintf(line + length, sizeof(line) - length, " | Div %.2f %.2f", getDiversity(feasibleSubpop), getDiversity(infeasibleSubpop));
+		length += std::snprintf(line + length, sizeof(line) - length, " | Feas %.2f %.2f", (double)std::count(listFeasibilityLoad.begin(), listFeasibilityLoad.end(), true) / (double)listFeasibilityLoad.size(), (double)std::count(listFeasibilityDuration.begin(), listFeasibilityDuration.end(), true) / (double)listFeasibilityDuration.size());
+		std::snprintf(line + length, sizeof(line) - length, " | Pen %.2f %.2f", params.penaltyCapacity, params.penaltyDuration);
+		params.log(line);
+	}
+}
 
-		std::printf(" | Div %.2f %.2f", getDiversity(feasibleSubpop), getDiversity(infeasibleSubpop));
-		std::printf(" | Feas %.2f %.2f", (double)std::count(listFeasibilityLoad.begin(), listFeasibilityLoad.end(), true) / (double)listFeasibilityLoad.size(), (double)std::count(listFeasibilityDuration.begin(), listFeasibilityDuration.end(), true) / (double)listFeasibilityDuration.size());
-		std::printf(" | Pen %.2f %.2f", params.penaltyCapacity, params.penaltyDuration);
-		std::cout << std::endl;
+void Population::recordState(TelemetryRecord & record)
+{
+	TelemetrySubpopulation * subpopRecords[2] = { &record.feasible, &record.infeasible };
+	SubPopulation * subpops[2] = { &feasibleSubpop, &infeasibleSubpop };
+	for (int i = 0; i < 2; i++)
+	{
+		subpopRecords[i]->size = (int)subpops[i]->size();
+		subpopRecords[i]->bestCost = subpops[i]->empty() ? 0. : (*subpops[i])[0]->eval.penalizedCost;
+		subpopRecords[i]->averageCost = getAverageCost(*subpops[i]);
+		subpopRecords[i]->diversity = getDiversity(*subpops[i]);
 	}
+	record.fractionFeasibleLoad = (double)std::count(listFeasibilityLoad.begin(), listFeasibilityLoad.end(), true) / (double)listFeasibilityLoad.size();
+	record.fractionFeasibleDuration = (double)std::count(listFeasibilityDuration.begin(), listFeasibilityDuration.end(), true) / (double)listFeasibilityDuration.size();
+	record.penaltyCapacity = params.penaltyCapacity;
+	record.penaltyDuration = params.penaltyDuration;
+	record.mdmEliteSize = (int)mdmElite.size();
+	record.mdmNbPatterns = (int)mdmPatterns.size();
+	record.mdmPatternUses = mdmPatternUses;
 }
 
 double Population::brokenPairsDistance(const Individual & indiv1, const Individual & indiv2)
@@ -376,6 +444,7 @@ double Population::averageBrokenPairsDistanceClosest(const Individual & indiv, i
 		result += it->first;
 		++it;
 	}
+	if (maxSize == 0) return 0.; // Individual alone in its subpopulation
 	return result / (double)maxSize;
 }
 
@@ -400,8 +469,8 @@ double Population::getAverageCost(const SubPopulation & pop)
 void Population::exportSearchProgress(std::string fileName, std::string instanceName)
 {
 	std::ofstream myfile(fileName);
-	for (std::pair<clock_t, double> state : searchProgress)
-		myfile << instanceName << ";" << params.ap.seed << ";" << state.second << ";" << (double)state.first / (double)CLOCKS_PER_SEC << std::endl;
+	for (std::pair<double, double> state : searchProgress)
+		myfile << instanceName << ";" << params.ap.seed << ";" << state.second << ";" << state.first << std::endl;
 }
 
 void Population::exportCVRPLibFormat(const Individual & indiv, std::string fileName)
@@ -414,13 +483,32 @@ void Population::exportCVRPLibFormat(const Individual & indiv, std::string fileN
 			if (!indiv.chromR[k].empty())
 			{
 				myfile << "Route #" << k + 1 << ":"; // Route IDs start at 1 in the file format
-				for (int i : indiv.chromR[k]) myfile << " " << i;
+				for (int i : indiv.chromR[k]) myfile << " " << params.originalIndex[i]; // Clients are written with their index in the input data
 				myfile << std::endl;
 			}
 		}
 		myfile << "Cost " << indiv.eval.penalizedCost << std::endl;
 	}
-	else std::cout << "----- IMPOSSIBLE TO OPEN: " << fileName << std::endl;
+	else params.log("----- IMPOSSIBLE TO OPEN: ", fileName);
+}
+
+std::vector < std::vector <int> > Population::readCVRPLibFormat(std::string fileName)
+{
+	std::ifstream myfile(fileName);
+	if (!myfile.is_open()) throw std::string("Impossible to open solution file: " + fileName);
+
+	std::vector < std::vector <int> > routes;
+	std::string line;
+	while (std::getline(myfile, line))
+	{
+		if (line.compare(0, 5, "Route") != 0) continue; // The cost line and any other line are ignored
+		std::size_t colon = line.find(':');
+		if (colon == std::string::npos) throw std::string("Unexpected route line in solution file: " + line);
+		std::istringstream routeStream(line.substr(colon + 1));
+		routes.push_back(std::vector <int>());
+		for (int client; routeStream >> client;) routes.back().push_back(client);
+	}
+	return routes;
 }
 
 // Comparator for ordering individuals by penalized cost
@@ -429,6 +517,131 @@ bool CompareIndividuals(Individual indiv1, Individual indiv2)
 	return indiv1.eval.penalizedCost < indiv2.eval.penalizedCost - MY_EPSILON;
 }
 
+void Population::writeSubpop(CheckpointWriter & writer, const SubPopulation & subpop) const
+{
+	writer.write((uint64_t)subpop.size());
+	for (const Individual * indiv : subpop) indiv->writeState(writer);
+
+	// The distances are kept as computed when the individuals were inserted, since the broken pairs distance is not symmetric
+	for (const Individual * indiv : subpop)
+	{
+		writer.write((uint64_t)indiv->indivsPerProximity.size());
+		for (const std::pair <double, Individual *> & neighbor : indiv->indivsPerProximity)
+		{
+			writer.write(neighbor.first);
+			writer.write((int)(std::find(subpop.begin(), subpop.end(), neighbor.second) - subpop.begin()));
+		}
+	}
+}
+
+void Population::readSubpop(CheckpointReader & reader, SubPopulation & subpop)
+{
+	for (Individual * indiv : subpop) delete indiv;
+	subpop.clear();
+	uint64_t size = reader.readSize();
+	for (uint64_t i = 0; i < size; i++)
+	{
+		subpop.push_back(new Individual(params));
+		subpop.back()->readState(reader);
+	}
+
+	for (Individual * indiv : subpop)
+	{
+		uint64_t nbNeighbors = reader.readSize();
+		for (uint64_t i = 0; i < nbNeighbors; i++)
+		{
+			double distance;
+			int position;
+			reader.read(distance);
+			reader.read(position);
+			if (position < 0 || position >= (int)subpop.size()) throw std::string("Corrupted checkpoint file");
+			indiv->indivsPerProximity.insert({ distance, subpop[position] });
+		}
+	}
+}
+
+void Population::writeState(CheckpointWriter & writer)
+{
+	writeSubpop(writer, feasibleSubpop);
+	writeSubpop(writer, infeasibleSubpop);
+	for (bool isFeasible : listFeasibilityLoad) writer.write(isFeasible);
+	for (bool isFeasible : listFeasibilityDuration) writer.write(isFeasible);
+	writer.write((uint64_t)searchProgress.size());
+	for (const std::pair <double, double> & state : searchProgress)
+	{
+		writer.write(state.first);
+		writer.write(state.second);
+	}
+	bestSolutionRestart.writeState(writer);
+	bestSolutionOverall.writeState(writer);
+
+	writer.write((uint64_t)mdmElite.size());
+	for (const Individual & indiv : mdmElite) indiv.writeState(writer);
+	writer.write(mdmEliteUpdated);
+	writer.write(mdmEliteNonUpdatingRestarts);
+	writer.write(mdmEliteMaxNonUpdatingRestarts);
+	writer.write(mdmPatterns);
+	writer.write(mdmNextPattern);
+
+	// Patterns mined in background are written as pending, and will be swapped in at the same point of the resumed search
+	bool hasPendingPatterns = mdmMiningResult.valid();
+	writer.write(hasPendingPatterns);
+	if (hasPendingPatterns)
+	{
+		std::vector< std::vector < std::vector <int> > > pendingPatterns = mdmMiningResult.get();
+		writer.write(pendingPatterns);
+		std::promise < std::vector< std::vector < std::vector <int> > > > pending;
+		pending.set_value(pendingPatterns);
+		mdmMiningResult = pending.get_future();
+	}
+}
+
+void Population::readState(CheckpointReader & reader)
+{
+	readSubpop(reader, feasibleSubpop);
+	readSubpop(reader, infeasibleSubpop);
+	for (std::list <bool> * listFeasibility : { &listFeasibilityLoad, &listFeasibilityDuration })
+		for (auto it = listFeasibility->begin(); it != listFeasibility->end(); ++it)
+		{
+			bool isFeasible;
+			reader.read(isFeasible);
+			*it = isFeasible;
+		}
+	searchProgress.resize(reader.readSize());
+	for (std::pair <double, double> & state : searchProgress)
+	{
+		reader.read(state.first);
+		reader.read(state.second);
+	}
+	bestSolutionRestart.readState(reader);
+	bestSolutionOverall.readState(reader);
+
+	mdmElite.clear();
+	uint64_t eliteSize = reader.readSize();
+	for (uint64_t i = 0; i < eliteSize; i++)
+	{
+		Individual indiv(params);
+		indiv.readState(reader);
+		mdmElite.insert(indiv);
+	}
+	reader.read(mdmEliteUpdated);
+	reader.read(mdmEliteNonUpdatingRestarts);
+	reader.read(mdmEliteMaxNonUpdatingRestarts);
+	reader.read(mdmPatterns);
+	reader.read(mdmNextPattern);
+
+	bool hasPendingPatterns;
+	reader.read(hasPendingPatterns);
+	if (hasPendingPatterns)
+	{
+		std::promise < std::vector< std::vector < std::vector <int> > > > pending;
+		std::vector< std::vector < std::vector <int> > > pendingPatterns;
+		reader.read(pendingPatterns);
+		pending.set_value(pendingPatterns);
+		mdmMiningResult = pending.get_future();
+	}
+}
+
 Population::Population(Params & params, Split & split, LocalSearch & localSearch) : params(params), split(split), localSearch(localSearch), bestSolutionRestart(params), bestSolutionOverall(params), mdmElite(CompareIndividuals)
 {
 	listFeasibilityLoad = std::list<bool>(100, true);
@@ -436,6 +649,10 @@ Population::Population(Params & params, Split & split, LocalSearch & localSearch
 
 	mdmEliteUpdated = false;
 	mdmEliteNonUpdatingRestarts = 0;
+	mdmEliteMaxNonUpdatingRestarts = 0;
+	mdmNextPattern = 0;
+	mdmPatternUses = 0;
+	isStopRequested = false;
 }
 
 Population::~Population()
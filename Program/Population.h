@@ -26,8 +26,12 @@ SOFTWARE.*/
 #include "Individual.h"
 #include "LocalSearch.h"
 #include "Split.h"
+#include "Telemetry.h"
 
 #include <set>
+#include <unordered_map>
+#include <future>
+#include <functional>
 
 typedef std::vector <Individual*> SubPopulation ;
 
@@ -42,7 +46,7 @@ class Population
    SubPopulation infeasibleSubpop;		        // Infeasible subpopulation, kept ordered by increasing penalized cost
    std::list <bool> listFeasibilityLoad ;		// Load feasibility of the last 100 individuals generated by LS
    std::list <bool> listFeasibilityDuration ;	// Duration feasibility of the last 100 individuals generated by LS
-   std::vector<std::pair<clock_t, double>> searchProgress; // Keeps tracks of the time stamps of successive best solutions
+   std::vector<std::pair<double, double>> searchProgress; // Keeps tracks of the time stamps (in seconds) of successive best solutions
    Individual bestSolutionRestart;              // Best solution found during the current restart of the algorithm
    Individual bestSolutionOverall;              // Best solution found during the complete execution of the algorithm
 
@@ -51,22 +55,32 @@ class Population
    int mdmEliteNonUpdatingRestarts;				// Number of restarts since the last time the MDM elite set was updated
    std::vector< std::vector < std::vector <int> > > mdmPatterns;	// Patterns mined from the MDM elite set
    int mdmNextPattern;							// Index of the next pattern to be used
+   uint64_t mdmPatternUses;						// Number of initial individuals built from a pattern
+   std::future< std::vector< std::vector < std::vector <int> > > > mdmMiningResult;	// Patterns being mined in background (if mdmBackgroundMining is set)
 
    // Evaluates the biased fitness of all individuals in the population
    void updateBiasedFitnesses(SubPopulation & pop);
 
-   // Removes the worst individual in terms of biased fitness
-   void removeWorstBiasedFitness(SubPopulation & subpop);
+   // Removes the worst individuals in terms of biased fitness until mu individuals remain (survivor selection)
+   void survivorsSelection(SubPopulation & subpop);
+
+   // Writes a subpopulation in a checkpoint, including the distances of the proximity structures
+   void writeSubpop(CheckpointWriter & writer, const SubPopulation & subpop) const;
+
+   // Reads a subpopulation from a checkpoint
+   void readSubpop(CheckpointReader & reader, SubPopulation & subpop);
 
    // Checks if an individual is eligible to be inserted in the MDM elite. If TRUE, inserts it.
    void updateMDMElite(const Individual & indiv);
 
-   // Retrieves the next pattern to be used.
+   // Retrieves the next pattern to be used (swapping in the patterns mined in background once they are ready).
    std::vector < std::vector <int> >* nextMDMPattern();
 
    public:
 
    int mdmEliteMaxNonUpdatingRestarts;			// Maximum number of restarts since the last update of the MDM elite set
+   std::function <bool(const Individual &)> newBestCallback;	// Called each time the best solution overall is improved (optional). Returning TRUE requests the termination of the search
+   bool isStopRequested;						// Tells whether the termination of the search has been requested (by newBestCallback or by the stop callback of Genetic)
 
    // Creates an initial population of individuals
    void generatePopulation();
@@ -75,6 +89,10 @@ class Population
    // Returns TRUE if a new best solution of the run has been found
    bool addIndividual (const Individual & indiv, bool updateFeasible);
 
+   // Adds an initial solution given as a set of routes (with the clients numbered as in the input data) after improving it with the local search
+   // If seedMDMElite is TRUE, the solution is also inserted in the MDM elite set (if feasible)
+   void addInitialSolution(const std::vector < std::vector <int> > & routes, bool seedMDMElite);
+
    // Cleans all solutions and generates a new initial population (only used when running HGS until a time limit, in which case the algorithm restarts until the time limit is reached)
    void restart();
 
@@ -96,6 +114,9 @@ class Population
    // Prints population state
    void printState(int nbIter, int nbIterNoImprovement);
 
+   // Fills the state of the population in a telemetry record (subpopulations, feasibility ratios, penalties and MDM patterns)
+   void recordState(TelemetryRecord & record);
+
    // Distance measure between two individuals, used for diversity calculations
    double brokenPairsDistance(const Individual & indiv1, const Individual & indiv2);
 
@@ -114,8 +135,20 @@ class Population
    // Exports an Individual in CVRPLib format
    void exportCVRPLibFormat(const Individual & indiv, std::string fileName);
 
-   // Mines patterns from the MDM elite set
-   void mineElite();
+   // Reads the routes of a solution in CVRPLib format (with the clients numbered as in the input data)
+   static std::vector < std::vector <int> > readCVRPLibFormat(std::string fileName);
+
+   // Writes the complete state of the population in a checkpoint (waiting for the patterns being mined in background, if any)
+   void writeState(CheckpointWriter & writer);
+
+   // Restores the state of the population from a checkpoint
+   void readState(CheckpointReader & reader);
+
+   // Mines patterns from the MDM elite set (in background if mdmBackgroundMining is set). Returns TRUE if a mining has been started
+   bool mineElite();
+
+   // Size of the MDM elite set
+   inline int mdmEliteSize() const { return (int)mdmElite.size(); }
 
    // Returns the state of the MDM patterns set: TRUE if empty; FALSE otherwise.
    inline bool mdmPatternsEmpty() { return mdmPatterns.empty(); }
@@ -0,0 +1,56 @@
+// Binary protocol of hgs-server (local solver service). This header file must be readable in C.
+// All values are in native endianness and layout: the protocol is only meant for clients running on the same machine as the server.
+
+#ifndef SERVERPROTOCOL_H
+#define SERVERPROTOCOL_H
+
+#include <stdint.h>
+#include "AlgorithmParameters.h"
+
+// Limits on the size of the requests: larger requests are rejected without being read
+#define HGS_MAX_NODES 1000000			// Maximum number of nodes of a request, depot included
+#define HGS_MAX_NODES_MATRIX 10000		// Maximum number of nodes of a request with a distance matrix (a payload of 800 MB)
+
+// Maximum number of requests of a connection not yet completed (waiting for a thread or being solved): the solve requests beyond it are refused without being read.
+// The payloads held for a connection are thus limited to 16 requests of at most 800 MB (with a distance matrix) or 32 MB (with coordinates only)
+#define HGS_MAX_PENDING_REQUESTS 16
+
+// Types of messages
+enum HgsMessageType
+{
+	HGS_MSG_SOLVE = 1,			// (client) Solve request
+	HGS_MSG_CANCEL = 2,			// (client) Cancels the request with the same identifier (no payload). The best solution found so far is returned
+	HGS_MSG_INCUMBENT = 3,		// (server) New best solution of a request (if stream_incumbents is set)
+	HGS_MSG_RESULT = 4,			// (server) Final solution of a request
+	HGS_MSG_ERROR = 5			// (server) The request failed or was cancelled before being started. The payload is an error message (not null-terminated).
+								// A message larger than the largest valid request is answered with an error, then the connection is closed
+};
+
+// Header of each message, followed by size bytes of payload
+struct HgsMessageHeader
+{
+	uint32_t type;				// Type of message (HgsMessageType)
+	uint32_t request_id;		// Identifier of the request, chosen by the client. A solve request whose identifier is used by a request of the connection not yet completed is refused
+	uint64_t size;				// Size of the payload in bytes
+};
+
+// Fixed part of the payload of a solve request, followed by the arrays x, y, service_time and demand (n doubles each, depot first),
+// then by the distance matrix if has_matrix is set (n*n doubles, row-major). The coordinates are ignored if has_coordinates is not set
+struct HgsSolveRequest
+{
+	int32_t n;						// Number of nodes, depot included
+	int32_t max_nb_veh;				// Maximum number of vehicles (INT_MAX for no limit)
+	double vehicle_capacity;		// Capacity limit
+	double duration_limit;			// Route duration limit
+	char is_rounding_integer;		// Rounding of the Euclidean distances (when no matrix is given)
+	char is_duration_constraint;	// Indicates if the duration limit applies
+	char has_coordinates;			// Indicates if the coordinates are meaningful (they are mandatory without distance matrix)
+	char has_matrix;				// Indicates if a distance matrix follows the arrays
+	char stream_incumbents;			// Indicates if each new best solution is sent back (HGS_MSG_INCUMBENT)
+	struct AlgorithmParameters ap;	// Parameters of the algorithm
+};
+
+// The payload of HGS_MSG_INCUMBENT and HGS_MSG_RESULT is: cost (double), time (double), n_routes (int32_t),
+// then for each route its length (int32_t) followed by its clients (int32_t each, numbered as in the request, depot excluded)
+
+#endif
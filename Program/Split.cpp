@@ -2,6 +2,7 @@
 
 void Split::generalSplit(Individual & indiv, int nbMaxVehicles)
 {
+	TraceSpan span(params.trace.get(), "Split::generalSplit");
 	// Do not apply Split with fewer vehicles than the trivial (LP) bin packing bound
 	maxVehicles = std::max<int>(nbMaxVehicles, std::ceil(params.totalDemand/params.vehicleCapacity));
 
@@ -35,31 +36,13 @@ int Split::splitSimple(Individual & indiv)
 	for (int i = 1; i <= params.nbClients; i++)
 		potential[0][i] = 1.e30;
 
-	// MAIN ALGORITHM -- Simple Split using Bellman's algorithm in topological order
-	// This code has been maintained as it is very simple and can be easily adapted to a variety of constraints, whereas the O(n) Split has a more restricted application scope
+	// MAIN ALGORITHM -- With duration constraints in O(n log n), otherwise in O(n)
 	if (params.isDurationConstraint)
 	{
-		for (int i = 0; i < params.nbClients; i++)
-		{
-			double load = 0.;
-			double distance = 0.;
-			double serviceDuration = 0.;
-			for (int j = i + 1; j <= params.nbClients && load <= 1.5 * params.vehicleCapacity ; j++)
-			{
-				load += cliSplit[j].demand;
-				serviceDuration += cliSplit[j].serviceTime;
-				if (j == i + 1) distance += cliSplit[j].d0_x;
-				else distance += cliSplit[j - 1].dnext;
-				double cost = distance + cliSplit[j].dx_0
-					+ params.penaltyCapacity * std::max<double>(load - params.vehicleCapacity, 0.)
-					+ params.penaltyDuration * std::max<double>(distance + cliSplit[j].dx_0 + serviceDuration - params.durationLimit, 0.);
-				if (potential[0][i] + cost < potential[0][j])
-				{
-					potential[0][j] = potential[0][i] + cost;
-					pred[0][j] = i;
-				}
-			}
-		}
+		propagateWithDuration(0, 0);
+#ifdef HGS_SPLIT_CHECK
+		checkLabelsWithDuration(0, 0);
+#endif
 	}
 	else
 	{
@@ -68,7 +51,7 @@ int Split::splitSimple(Individual & indiv)
 		{
 			// The front is the best predecessor for i
 			potential[0][i] = propagate(queue.get_front(), i, 0);
-			pred[0][i] = queue.get_front();
+			predecessor(0, i) = queue.get_front();
 
 			if (i < params.nbClients)
 			{
@@ -90,6 +73,12 @@ int Split::splitSimple(Individual & indiv)
 	if (potential[0][params.nbClients] > 1.e29)
 		throw std::string("ERROR : no Split solution has been propagated until the last node");
 
+	// Counting the routes, the Split with limited fleet is needed if there are more than maxVehicles
+	int nbRoutes = 0;
+	for (int end = params.nbClients; end > 0 && nbRoutes <= maxVehicles; end = predecessor(0, end))
+		nbRoutes++;
+	if (nbRoutes > maxVehicles) return 0;
+
 	// Filling the chromR structure
 	for (int k = params.nbVehicles - 1; k >= maxVehicles; k--)
 		indiv.chromR[k].clear();
@@ -98,52 +87,35 @@ int Split::splitSimple(Individual & indiv)
 	for (int k = maxVehicles - 1; k >= 0; k--)
 	{
 		indiv.chromR[k].clear();
-		int begin = pred[0][end];
+		int begin = (end > 0) ? predecessor(0, end) : 0;
 		for (int ii = begin; ii < end; ii++)
 			indiv.chromR[k].push_back(indiv.chromT[ii]);
 		end = begin;
 	}
-
-	// Return OK in case the Split algorithm reached the beginning of the routes
-	return (end == 0);
+	return 1;
 }
 
 // Split for problems with limited fleet
 int Split::splitLF(Individual & indiv)
 {
-	// Initialize the potential structures
+	// Initialize the potential structures (the predecessors are stored for up to maxVehicles routes, only for the nodes which can be reached)
+	std::size_t predSize = (std::size_t)(maxVehicles + 1) * (params.nbClients + 1) - (std::size_t)(maxVehicles + 1) * maxVehicles / 2;
+	if (pred.size() < predSize) pred.resize(predSize);
 	potential[0][0] = 0;
-	for (int k = 0; k <= maxVehicles; k++)
-		for (int i = 1; i <= params.nbClients; i++)
-			potential[k][i] = 1.e30;
+	for (int i = 1; i <= params.nbClients; i++)
+		potential[0][i] = 1.e30;
 
-	// MAIN ALGORITHM -- Simple Split using Bellman's algorithm in topological order
-	// This code has been maintained as it is very simple and can be easily adapted to a variety of constraints, whereas the O(n) Split has a more restricted application scope
-	if (params.isDurationConstraint) 
+	// MAIN ALGORITHM -- With duration constraints in O(n log n) for each number of routes
+	if (params.isDurationConstraint)
 	{
 		for (int k = 0; k < maxVehicles; k++)
 		{
-			for (int i = k; i < params.nbClients && potential[k][i] < 1.e29 ; i++)
-			{
-				double load = 0.;
-				double serviceDuration = 0.;
-				double distance = 0.;
-				for (int j = i + 1; j <= params.nbClients && load <= 1.5 * params.vehicleCapacity ; j++) // Setting a maximum limit on load infeasibility to accelerate the algorithm
-				{
-					load += cliSplit[j].demand;
-					serviceDuration += cliSplit[j].serviceTime;
-					if (j == i + 1) distance += cliSplit[j].d0_x;
-					else distance += cliSplit[j - 1].dnext;
-					double cost = distance + cliSplit[j].dx_0
-								+ params.penaltyCapacity * std::max<double>(load - params.vehicleCapacity, 0.)
-								+ params.penaltyDuration * std::max<double>(distance + cliSplit[j].dx_0 + serviceDuration - params.durationLimit, 0.);
-					if (potential[k][i] + cost < potential[k + 1][j])
-					{
-						potential[k + 1][j] = potential[k][i] + cost;
-						pred[k + 1][j] = i;
-					}
-				}
-			}
+			std::fill(potential[(k + 1) % 2].begin(), potential[(k + 1) % 2].end(), 1.e30);
+			propagateWithDuration(k, k + 1);
+#ifdef HGS_SPLIT_CHECK
+			checkLabelsWithDuration(k, k + 1);
+#endif
+			potentialEnd[k + 1] = potential[(k + 1) % 2][params.nbClients];
 		}
 	}
 	else // MAIN ALGORITHM -- Without duration constraints in O(n), from "Vidal, T. (2016). Split algorithm in O(n) for the capacitated vehicle routing problem. C&OR"
@@ -153,14 +125,15 @@ int Split::splitLF(Individual & indiv)
 		{
 			// in the Split problem there is always one feasible solution with k routes that reaches the index k in the tour.
 			queue.reset(k);
+			std::fill(potential[(k + 1) % 2].begin(), potential[(k + 1) % 2].end(), 1.e30);
 
 			// The range of potentials < 1.29 is always an interval.
 			// The size of the queue will stay >= 1 until we reach the end of this interval.
 			for (int i = k + 1; i <= params.nbClients && queue.size() > 0; i++)
 			{
 				// The front is the best predecessor for i
-				potential[k + 1][i] = propagate(queue.get_front(), i, k);
-				pred[k + 1][i] = queue.get_front();
+				potential[(k + 1) % 2][i] = propagate(queue.get_front(), i, k);
+				predecessor(k + 1, i) = queue.get_front();
 
 				if (i < params.nbClients)
 				{
@@ -178,18 +151,19 @@ int Split::splitLF(Individual & indiv)
 						queue.pop_front();
 				}
 			}
+			potentialEnd[k + 1] = potential[(k + 1) % 2][params.nbClients];
 		}
 	}
 
-	if (potential[maxVehicles][params.nbClients] > 1.e29)
+	if (potentialEnd[maxVehicles] > 1.e29)
 		throw std::string("ERROR : no Split solution has been propagated until the last node");
 
 	// It could be cheaper to use a smaller number of vehicles
-	double minCost = potential[maxVehicles][params.nbClients];
+	double minCost = potentialEnd[maxVehicles];
 	int nbRoutes = maxVehicles;
 	for (int k = 1; k < maxVehicles; k++)
-		if (potential[k][params.nbClients] < minCost)
-			{minCost = potential[k][params.nbClients]; nbRoutes = k;}
+		if (potentialEnd[k] < minCost)
+			{minCost = potentialEnd[k]; nbRoutes = k;}
 
 	// Filling the chromR structure
 	for (int k = params.nbVehicles-1; k >= nbRoutes ; k--)
@@ -199,7 +173,7 @@ int Split::splitLF(Individual & indiv)
 	for (int k = nbRoutes - 1; k >= 0; k--)
 	{
 		indiv.chromR[k].clear();
-		int begin = pred[k+1][end];
+		int begin = predecessor(k + 1, end);
 		for (int ii = begin; ii < end; ii++)
 			indiv.chromR[k].push_back(indiv.chromT[ii]);
 		end = begin;
@@ -209,6 +183,64 @@ int Split::splitLF(Individual & indiv)
 	return (end == 0);
 }
 
+void Split::propagateWithDuration(int k, int kNext)
+{
+	int front = 0;
+	int back = -1;
+	for (int j = (kNext == k) ? 1 : k + 1; j <= params.nbClients; j++)
+	{
+		// Node j-1 becomes a candidate predecessor (its label is final)
+		int i = j - 1;
+		if (potential[k % 2][i] < 1.e29)
+		{
+			// Removing the candidates which are worse than i from the first node where they are the best
+			while (back >= front && propagateDuration(i, std::max<int>(candidateStart[back], j), k) < propagateDuration(candidates[back], std::max<int>(candidateStart[back], j), k))
+				back--;
+
+			if (back < front)
+			{
+				candidates[++back] = i;
+				candidateStart[back] = j;
+			}
+			else if (propagateDuration(i, params.nbClients, k) < propagateDuration(candidates[back], params.nbClients, k))
+			{
+				// Binary search of the first node for which i is better than the last candidate
+				int lower = std::max<int>(candidateStart[back], j) + 1;
+				int upper = params.nbClients;
+				while (lower < upper)
+				{
+					int middle = (lower + upper) / 2;
+					if (propagateDuration(i, middle, k) < propagateDuration(candidates[back], middle, k)) upper = middle;
+					else lower = middle + 1;
+				}
+				candidates[++back] = i;
+				candidateStart[back] = lower;
+			}
+		}
+		if (back < front) continue;
+
+		// The front is the best predecessor for j
+		while (back > front && candidateStart[front + 1] <= j) front++;
+		potential[kNext % 2][j] = propagateDuration(candidates[front], j, k);
+		predecessor(kNext, j) = candidates[front];
+	}
+}
+
+#ifdef HGS_SPLIT_CHECK
+void Split::checkLabelsWithDuration(int k, int kNext)
+{
+	for (int j = (kNext == k) ? 1 : k + 1; j <= params.nbClients; j++)
+	{
+		double bestLabel = 1.e30;
+		for (int i = (kNext == k) ? 0 : k; i < j; i++)
+			if (potential[k % 2][i] < 1.e29) bestLabel = std::min<double>(bestLabel, propagateDuration(i, j, k));
+		if (std::abs(potential[kNext % 2][j] - bestLabel) > MY_EPSILON)
+			throw std::string("SPLIT CHECK: the label of node " + std::to_string(j) + " with " + std::to_string(kNext) + " routes is " + std::to_string(potential[kNext % 2][j])
+				+ " instead of " + std::to_string(bestLabel));
+	}
+}
+#endif
+
 Split::Split(const Params & params): params(params)
 {
 	// Structures of the linear Split
@@ -216,6 +248,9 @@ Split::Split(const Params & params): params(params)
 	sumDistance = std::vector <double>(params.nbClients + 1,0.);
 	sumLoad = std::vector <double>(params.nbClients + 1,0.);
 	sumService = std::vector <double>(params.nbClients + 1, 0.);
-	potential = std::vector < std::vector <double> >(params.nbVehicles + 1, std::vector <double>(params.nbClients + 1,1.e30));
-	pred = std::vector < std::vector <int> >(params.nbVehicles + 1, std::vector <int>(params.nbClients + 1,0));
+	candidates = std::vector <int>(params.nbClients + 1);
+	candidateStart = std::vector <int>(params.nbClients + 1);
+	potential = std::vector < std::vector <double> >(2, std::vector <double>(params.nbClients + 1,1.e30));
+	potentialEnd = std::vector <double>(params.nbVehicles + 1, 1.e30);
+	pred = std::vector <int>(params.nbClients + 1, 0);
 }
@@ -71,17 +71,26 @@ class Split
 
  /* Auxiliary data structures to run the Linear Split algorithm */
  std::vector < ClientSplit > cliSplit;
- std::vector < std::vector < double > > potential;  // Potential vector
- std::vector < std::vector < int > > pred;  // Indice of the predecessor in an optimal path
+ std::vector < std::vector < double > > potential;  // Potential vectors, for the current and next number of routes (potential[k % 2] contains the potentials with k routes)
+ std::vector <double> potentialEnd; // potentialEnd[k] contains the potential of the last node with k routes
+ std::vector <int> pred;  // Indice of the predecessor in an optimal path, for each number of routes k and node i >= k (only the unlimited fleet, k = 0, until the limited fleet is needed)
  std::vector <double> sumDistance; // sumDistance[i] for i > 1 contains the sum of distances : sum_{k=1}^{i-1} d_{k,k+1}
  std::vector <double> sumLoad; // sumLoad[i] for i >= 1 contains the sum of loads : sum_{k=1}^{i} q_k
  std::vector <double> sumService; // sumService[i] for i >= 1 contains the sum of service time : sum_{k=1}^{i} s_k
+ std::vector <int> candidates; // Candidate predecessors of the Split with duration constraints, by increasing index
+ std::vector <int> candidateStart; // candidateStart[c] is the first node for which candidates[c] is the best predecessor
+
+ // Predecessor of node i >= k in an optimal path with k routes (k = 0 for the unlimited fleet)
+ inline int & predecessor(int k, int i)
+ {
+	 return pred[(std::size_t)k * (params.nbClients + 1) - (std::size_t)k * (k - 1) / 2 + i - k];
+ }
 
  // To be called with i < j only
  // Computes the cost of propagating the label i until j
  inline double propagate(int i, int j, int k)
  {
-	 return potential[k][i] + sumDistance[j] - sumDistance[i + 1] + cliSplit[i + 1].d0_x + cliSplit[j].dx_0
+	 return potential[k % 2][i] + sumDistance[j] - sumDistance[i + 1] + cliSplit[i + 1].d0_x + cliSplit[j].dx_0
 		 + params.penaltyCapacity * std::max<double>(sumLoad[j] - sumLoad[i] - params.vehicleCapacity, 0.);
  }
 
@@ -89,7 +98,7 @@ class Split
  // We assume that i < j
  inline bool dominates(int i, int j, int k)
  {
-	 return potential[k][j] + cliSplit[j + 1].d0_x > potential[k][i] + cliSplit[i + 1].d0_x + sumDistance[j + 1] - sumDistance[i + 1]
+	 return potential[k % 2][j] + cliSplit[j + 1].d0_x > potential[k % 2][i] + cliSplit[i + 1].d0_x + sumDistance[j + 1] - sumDistance[i + 1]
 		 + params.penaltyCapacity * (sumLoad[j] - sumLoad[i]);
  }
 
@@ -97,9 +106,30 @@ class Split
  // We assume that i < j
  inline bool dominatesRight(int i, int j, int k)
  {
-	 return potential[k][j] + cliSplit[j + 1].d0_x < potential[k][i] + cliSplit[i + 1].d0_x + sumDistance[j + 1] - sumDistance[i + 1] + MY_EPSILON;
+	 return potential[k % 2][j] + cliSplit[j + 1].d0_x < potential[k % 2][i] + cliSplit[i + 1].d0_x + sumDistance[j + 1] - sumDistance[i + 1] + MY_EPSILON;
  }
 
+  // To be called with i < j only
+  // Computes the cost of propagating the label i until j, with penalized excess load and duration
+  inline double propagateDuration(int i, int j, int k)
+  {
+	  double distance = sumDistance[j] - sumDistance[i + 1] + cliSplit[i + 1].d0_x + cliSplit[j].dx_0;
+	  return potential[k % 2][i] + distance
+		  + params.penaltyCapacity * std::max<double>(sumLoad[j] - sumLoad[i] - params.vehicleCapacity, 0.)
+		  + params.penaltyDuration * std::max<double>(distance + sumService[j] - sumService[i] - params.durationLimit, 0.);
+  }
+
+  // Computes the labels of layer kNext from the labels of layer k, with duration constraints (kNext == k for the unlimited fleet)
+  // When the distances satisfy the triangle inequality, the route costs satisfy the quadrangle inequality: once a predecessor is better than an earlier one, it remains better for all the following nodes
+  // The nodes for which each candidate predecessor is the best then form consecutive intervals, found by binary search, hence a complexity in O(n log n)
+  void propagateWithDuration(int k, int kNext);
+
+#ifdef HGS_SPLIT_CHECK
+  // Reference check of propagateWithDuration (only compiled in with the HGS_SPLIT_CHECK option): the label of each node of layer kNext must be the minimum over all its predecessors (exhaustive Bellman propagation, in O(n^2))
+  // The labels may legitimately differ when the distances do not satisfy the triangle inequality
+  void checkLabelsWithDuration(int k, int kNext);
+#endif
+
   // Split for unlimited fleet
   int splitSimple(Individual & indiv);
 
@@ -0,0 +1,113 @@
+#include "Telemetry.h"
+
+#include <iostream>
+#include <cmath>
+
+Telemetry::Telemetry(std::string fileName, int capacity) : file(fileName), ring(capacity), first(0), nbRecords(0), nbDropped(0), stopWriting(false)
+{
+	if (!file.is_open()) throw std::string("Impossible to open telemetry file: " + fileName);
+	file.precision(10);
+	writer = std::thread(&Telemetry::writerLoop, this);
+}
+
+Telemetry::~Telemetry()
+{
+	{
+		std::lock_guard <std::mutex> lock(ringMutex);
+		stopWriting = true;
+	}
+	recordAdded.notify_one();
+	writer.join();
+}
+
+void Telemetry::record(const TelemetryRecord & record)
+{
+	{
+		std::lock_guard <std::mutex> lock(ringMutex);
+		if (nbRecords == (int)ring.size())
+		{
+			first = (first + 1) % (int)ring.size();
+			nbRecords--;
+			nbDropped++;
+		}
+		ring[(first + nbRecords) % (int)ring.size()] = record;
+		nbRecords++;
+	}
+	recordAdded.notify_one();
+}
+
+void Telemetry::writerLoop()
+{
+	std::vector <TelemetryRecord> pending;
+	while (true)
+	{
+		uint64_t nbDroppedPending;
+		bool isLast;
+		{
+			std::unique_lock <std::mutex> lock(ringMutex);
+			recordAdded.wait(lock, [&] { return stopWriting || nbRecords > 0; });
+			pending.clear();
+			for (int i = 0; i < nbRecords; i++) pending.push_back(ring[(first + i) % (int)ring.size()]);
+			first = (first + nbRecords) % (int)ring.size();
+			nbRecords = 0;
+			nbDroppedPending = nbDropped;
+			nbDropped = 0;
+			isLast = stopWriting;
+		}
+
+		// The records are formatted and written without holding the lock
+		if (nbDroppedPending > 0) file << "{\"event\":\"dropped\",\"count\":" << nbDroppedPending << "}\n";
+		for (const TelemetryRecord & record : pending) writeJSON(file, record);
+		file.flush();
+		if (isLast) return;
+	}
+}
+
+// Writes a number (null if it is not finite, since JSON has no representation of NaN and infinities)
+static void writeNumber(std::ostream & out, double value)
+{
+	if (std::isfinite(value)) out << value;
+	else out << "null";
+}
+
+// Writes the state of a subpopulation (null if it is empty)
+static void writeSubpopulation(std::ostream & out, const TelemetrySubpopulation & subpop)
+{
+	if (subpop.size == 0) { out << "{\"size\":0,\"best\":null,\"average\":null,\"diversity\":null}"; return; }
+	out << "{\"size\":" << subpop.size << ",\"best\":";
+	writeNumber(out, subpop.bestCost);
+	out << ",\"average\":";
+	writeNumber(out, subpop.averageCost);
+	out << ",\"diversity\":";
+	writeNumber(out, subpop.diversity);
+	out << "}";
+}
+
+void Telemetry::writeJSON(std::ostream & out, const TelemetryRecord & record)
+{
+	static const char * eventNames[] = { "state", "restart", "mining" };
+	out << "{\"event\":\"" << eventNames[record.event] << "\",\"time\":" << record.time << ",\"iter\":" << record.nbIter << ",\"restarts\":" << record.nbRestarts;
+	if (record.event == TelemetryRecord::STATE)
+	{
+		out << ",\"itersPerSecond\":";
+		writeNumber(out, record.itersPerSecond);
+		out << ",\"lsTimeShare\":";
+		writeNumber(out, record.lsTimeShare);
+		out << ",\"feasible\":";
+		writeSubpopulation(out, record.feasible);
+		out << ",\"infeasible\":";
+		writeSubpopulation(out, record.infeasible);
+		out << ",\"fractionFeasibleLoad\":";
+		writeNumber(out, record.fractionFeasibleLoad);
+		out << ",\"fractionFeasibleDuration\":";
+		writeNumber(out, record.fractionFeasibleDuration);
+		out << ",\"penaltyCapacity\":";
+		writeNumber(out, record.penaltyCapacity);
+		out << ",\"penaltyDuration\":";
+		writeNumber(out, record.penaltyDuration);
+		out << ",\"mdmEliteSize\":" << record.mdmEliteSize << ",\"mdmPatterns\":" << record.mdmNbPatterns << ",\"mdmPatternUses\":" << record.mdmPatternUses;
+	}
+	else if (record.event == TelemetryRecord::MINING)
+		out << ",\"mdmEliteSize\":" << record.mdmEliteSize;
+	out << "}\n";
+}
@@ -0,0 +1,79 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// State of a subpopulation in a telemetry record
+struct TelemetrySubpopulation
+{
+	int size;						// Number of individuals
+	double bestCost;				// Penalized cost of the best individual (meaningless if size is null)
+	double averageCost;				// Average penalized cost of the mu best individuals
+	double diversity;				// Average broken pairs distance among the mu best individuals
+};
+
+// Record of the telemetry stream
+struct TelemetryRecord
+{
+	enum Event { STATE, RESTART, MINING };
+	Event event;					// Periodic state of the search, restart of the population, or start of a pattern mining
+	double time;					// Elapsed time in seconds
+	int nbIter;						// Number of iterations since the beginning of the search
+	int nbRestarts;					// Number of restarts of the population
+	double itersPerSecond;			// (STATE) Iterations per second since the previous state record
+	double lsTimeShare;				// (STATE) Share of the time of the search threads spent in the local search since the previous state record
+	TelemetrySubpopulation feasible;	// (STATE) Feasible subpopulation
+	TelemetrySubpopulation infeasible;	// (STATE) Infeasible subpopulation
+	double fractionFeasibleLoad;	// (STATE) Ratio of load-feasible individuals among the last 100 generated by the local search
+	double fractionFeasibleDuration;	// (STATE) Ratio of duration-feasible individuals among the last 100 generated by the local search
+	double penaltyCapacity;			// (STATE) Penalty values
+	double penaltyDuration;
+	int mdmEliteSize;				// (STATE, MINING) Size of the MDM elite set
+	int mdmNbPatterns;				// (STATE) Number of patterns currently used to build the initial individuals
+	uint64_t mdmPatternUses;		// (STATE) Number of initial individuals built from a pattern since the beginning of the search
+};
+
+// Stream of telemetry records written as JSON lines
+// The records are copied in a ring buffer by the search, and formatted and written to the file by a background thread. If the thread falls behind, the oldest records are dropped (and counted)
+class Telemetry
+{
+public:
+
+	// Opens the telemetry file (truncated) and starts the writing thread
+	Telemetry(std::string fileName, int capacity = 1024);
+
+	// Writes the remaining records and stops the writing thread
+	~Telemetry();
+
+	// Adds a record to the ring buffer
+	void record(const TelemetryRecord & record);
+
+	Telemetry(const Telemetry &) = delete;
+	Telemetry & operator=(const Telemetry &) = delete;
+
+private:
+
+	std::ofstream file;						// Output file
+	std::vector <TelemetryRecord> ring;		// Ring buffer of the records waiting to be written
+	int first;								// Position of the oldest record in the ring
+	int nbRecords;							// Number of records in the ring
+	uint64_t nbDropped;						// Number of records dropped since the last write
+	bool stopWriting;						// Tells the writing thread to terminate
+	std::mutex ringMutex;
+	std::condition_variable recordAdded;
+	std::thread writer;						// Writing thread
+
+	// Loop of the writing thread
+	void writerLoop();
+
+	// Writes a record as one line of JSON
+	static void writeJSON(std::ostream & out, const TelemetryRecord & record);
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "Trace.h"
+
+Trace::Trace(std::string fileName) : file(fileName), origin(std::chrono::steady_clock::now())
+{
+	if (!file.is_open()) throw std::string("Impossible to open trace file: " + fileName);
+	file << "[";
+}
+
+Trace::~Trace()
+{
+	file << "\n]\n";
+}
+
+void Trace::addSpan(const char * name, std::chrono::steady_clock::time_point start)
+{
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	long long startMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(start - origin).count();
+	long long durationMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+	std::lock_guard <std::mutex> lock(fileMutex);
+	std::thread::id threadId = std::this_thread::get_id();
+	int tid = 0;
+	while (tid < (int)threadIds.size() && threadIds[tid] != threadId) tid++;
+	if (tid == (int)threadIds.size())
+	{
+		// Names the thread in the viewer the first time it records a span
+		threadIds.push_back(threadId);
+		file << (tid == 0 ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+			<< ",\"args\":{\"name\":\"" << (tid == 0 ? std::string("main") : "thread " + std::to_string(tid)) << "\"}}";
+	}
+	file << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid << ",\"ts\":" << startMicroseconds << ",\"dur\":" << durationMicroseconds << "}";
+}
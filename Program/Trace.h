@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+// Trace of the phases of the search, written in the Chrome trace event format (JSON), which can be opened in chrome://tracing or ui.perfetto.dev
+// The spans are written as they complete (under a lock, so that all threads of the search can record spans). The file is closed by the destructor
+class Trace
+{
+public:
+
+	// Opens the trace file (truncated)
+	Trace(std::string fileName);
+
+	// Completes the JSON array of events and closes the file
+	~Trace();
+
+	// Writes a span which started at the given time and ends now, in the current thread
+	void addSpan(const char * name, std::chrono::steady_clock::time_point start);
+
+	Trace(const Trace &) = delete;
+	Trace & operator=(const Trace &) = delete;
+
+private:
+
+	std::ofstream file;								// Output file
+	std::chrono::steady_clock::time_point origin;	// Time origin of the trace
+	std::vector <std::thread::id> threadIds;		// Threads having recorded a span, numbered by order of appearance
+	std::mutex fileMutex;
+};
+
+// Span covering the lifetime of this object (nothing is recorded if the trace is null)
+class TraceSpan
+{
+	Trace * trace;
+	const char * name;
+	std::chrono::steady_clock::time_point start;
+
+public:
+
+	TraceSpan(Trace * trace, const char * name) : trace(trace), name(name)
+	{
+		if (trace) start = std::chrono::steady_clock::now();
+	}
+
+	~TraceSpan() { close(); }
+
+	// Ends the span before the end of the scope
+	void close()
+	{
+		if (trace) trace->addSpan(name, start);
+		trace = nullptr;
+	}
+
+	TraceSpan(const TraceSpan &) = delete;
+	TraceSpan & operator=(const TraceSpan &) = delete;
+};
+
+#endif
@@ -0,0 +1,329 @@
+// Report of a quality-versus-time benchmark: reads the search progress files (.PG.csv) written by the runs of the solver,
+// and computes for each set of instances the gap curve and the primal integral, optionally compared with the runs of another build
+// The runs are produced by Test/Benchmark.cmake (target "benchmark")
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
+
+// Fractions of the time budget at which the gap curve is measured
+static const std::vector <double> curveFractions = { 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0 };
+
+// Run of the solver on an instance, with the successive best solutions found
+struct BenchmarkRun
+{
+	std::string instance;								// Name of the instance (file name without extension)
+	std::string path;									// Path of the instance, as given to the solver
+	int seed;											// Random seed
+	std::vector < std::pair <double, double> > progress;	// Time stamps (in seconds) and costs of the successive best solutions
+};
+
+// Indicators of a run, with respect to the reference cost of its instance
+struct RunIndicators
+{
+	double finalCost;					// Best cost found within the time budget (-1 if none)
+	double finalGap;					// Relative gap (in %) of this cost to the reference (100 if no solution was found)
+	double primalIntegral;				// Integral of the primal gap over the time budget (in seconds)
+	std::vector <double> curve;			// Primal gap (in %) at each fraction of the time budget
+};
+
+// Sums of the indicators of a group of runs
+struct GroupIndicators
+{
+	int nbRuns = 0;
+	double finalGap = 0.;
+	double primalIntegral = 0.;
+	std::vector <double> curve = std::vector <double>(curveFractions.size(), 0.);
+	void add(const RunIndicators & run)
+	{
+		nbRuns++;
+		finalGap += run.finalGap;
+		primalIntegral += run.primalIntegral;
+		for (int i = 0; i < (int)curve.size(); i++) curve[i] += run.curve[i];
+	}
+};
+
+// Set of an instance: the letters preceding its number (X, CMT, Golden)
+static std::string instanceSet(const std::string & instance)
+{
+	size_t end = 0;
+	while (end < instance.size() && std::isalpha((unsigned char)instance[end])) end++;
+	return instance.substr(0, end);
+}
+
+// Reads the runs whose search progress is in a directory (one file per run, one line per new best solution: instancePath;seed;cost;time)
+static std::vector <BenchmarkRun> readRuns(const std::string & directory)
+{
+	if (!std::filesystem::is_directory(directory)) throw std::string("Impossible to open benchmark directory: " + directory);
+	std::vector <std::string> files;
+	for (const auto & entry : std::filesystem::directory_iterator(directory))
+	{
+		std::string fileName = entry.path().string();
+		if (fileName.size() > 7 && fileName.compare(fileName.size() - 7, 7, ".PG.csv") == 0) files.push_back(fileName);
+	}
+	std::sort(files.begin(), files.end());
+
+	std::vector <BenchmarkRun> runs;
+	for (const std::string & fileName : files)
+	{
+		std::ifstream file(fileName);
+		BenchmarkRun run;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			std::vector <std::string> fields;
+			std::istringstream lineStream(line);
+			std::string field;
+			while (std::getline(lineStream, field, ';')) fields.push_back(field);
+			if (fields.size() != 4) throw std::string("Incorrect line in search progress file " + fileName + ": " + line);
+			run.path = fields[0];
+			run.seed = std::atoi(fields[1].c_str());
+			run.progress.push_back({ std::atof(fields[3].c_str()), std::atof(fields[2].c_str()) });
+		}
+		if (run.progress.empty()) continue;
+		run.instance = std::filesystem::path(run.path).stem().string();
+		std::sort(run.progress.begin(), run.progress.end());
+		runs.push_back(run);
+	}
+	return runs;
+}
+
+// Reads the best known solution value written in the COMMENT field of an instance file (CMT and Golden instances). Returns -1 if there is none
+static double readInstanceBKS(const std::string & path)
+{
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.compare(0, 7, "COMMENT") != 0) continue;
+		size_t start = line.find_first_not_of(" \t:", 7);
+		if (start == std::string::npos) return -1.;
+		char * end;
+		double value = std::strtod(line.c_str() + start, &end);
+		if (end == line.c_str() + start || line.find_first_not_of(" \t\r", end - line.c_str()) != std::string::npos) return -1.;
+		return value;
+	}
+	return -1.;
+}
+
+// Primal gap of a cost to the reference, between 0 and 1 (1 if no solution has been found yet)
+static double primalGap(double cost, double reference)
+{
+	if (cost < 0.) return 1.;
+	if (std::fabs(cost - reference) < 1.e-9) return 0.;
+	return std::fabs(cost - reference) / std::max<double>(std::fabs(cost), std::fabs(reference));
+}
+
+// Best cost found by a run up to a given time (-1 if none)
+static double costAt(const BenchmarkRun & run, double time)
+{
+	double cost = -1.;
+	for (const std::pair <double, double> & state : run.progress)
+	{
+		if (state.first > time) break;
+		cost = state.second;
+	}
+	return cost;
+}
+
+static RunIndicators computeIndicators(const BenchmarkRun & run, double reference, double timeBudget)
+{
+	RunIndicators indicators;
+	indicators.finalCost = costAt(run, timeBudget);
+	indicators.finalGap = (indicators.finalCost < 0.) ? 100. : 100. * (indicators.finalCost - reference) / reference;
+
+	// The primal gap is a step function, constant between two new best solutions
+	indicators.primalIntegral = 0.;
+	double time = 0.;
+	double cost = -1.;
+	for (const std::pair <double, double> & state : run.progress)
+	{
+		if (state.first > timeBudget) break;
+		indicators.primalIntegral += primalGap(cost, reference) * (state.first - time);
+		time = state.first;
+		cost = state.second;
+	}
+	indicators.primalIntegral += primalGap(cost, reference) * (timeBudget - time);
+
+	for (double fraction : curveFractions)
+		indicators.curve.push_back(100. * primalGap(costAt(run, fraction * timeBudget), reference));
+	return indicators;
+}
+
+static void printHeader()
+{
+	std::cout << std::left << std::setw(8) << "Set" << std::setw(10) << "Build" << std::right << std::setw(6) << "Runs"
+		<< std::setw(13) << "FinalGap(%)" << std::setw(13) << "Integral(s)" << " | Primal gap (%) at";
+	for (double fraction : curveFractions)
+	{
+		std::ostringstream label;
+		label << 100. * fraction << "%";
+		std::cout << std::setw(8) << label.str();
+	}
+	std::cout << std::endl;
+}
+
+static void printIndicators(const std::string & set, const std::string & build, const GroupIndicators & group, bool isAverage)
+{
+	double factor = (isAverage && group.nbRuns > 0) ? 1. / (double)group.nbRuns : 1.;
+	std::cout << std::left << std::setw(8) << set << std::setw(10) << build << std::right << std::setw(6) << (isAverage ? std::to_string(group.nbRuns) : "")
+		<< std::fixed << std::setprecision(3) << std::setw(13) << factor * group.finalGap << std::setw(13) << factor * group.primalIntegral << " |                  ";
+	for (double value : group.curve) std::cout << std::setw(8) << factor * value;
+	std::cout << std::defaultfloat << std::endl;
+}
+
+static void displayHelp()
+{
+	std::cout << std::endl;
+	std::cout << "-------------------------------------------------- HGS-CVRP benchmark report ---------------------------------------------------" << std::endl;
+	std::cout << "Call with: ./hgs-benchmark resultDirectory -t timeBudget [-baseline directory] [-bks path] [-csv path]                          " << std::endl;
+	std::cout << "[resultDirectory] directory holding the search progress files (.PG.csv) of the runs, one file per run                           " << std::endl;
+	std::cout << "[-t <double>] time budget of each run in seconds, over which the primal integral is computed                                    " << std::endl;
+	std::cout << "[-baseline <string>] directory holding the runs of another build, compared with the ones of resultDirectory                     " << std::endl;
+	std::cout << "[-bks <string>] file of reference costs (one line per instance: name cost). Defaults to the COMMENT field of the instance files " << std::endl;
+	std::cout << "                or, when it holds no value, to the best cost found by the runs of the instance                                  " << std::endl;
+	std::cout << "[-csv <string>] writes the indicators of each run in a CSV file                                                                 " << std::endl;
+	std::cout << "--------------------------------------------------------------------------------------------------------------------------------" << std::endl;
+	std::cout << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc < 2 || argc % 2 != 0) { displayHelp(); return 1; }
+	std::string resultDirectory = argv[1];
+	std::string baselineDirectory;
+	std::string pathBKS;
+	std::string pathCSV;
+	double timeBudget = 0.;
+	for (int i = 2; i < argc; i += 2)
+	{
+		if (std::string(argv[i]) == "-t") timeBudget = std::atof(argv[i + 1]);
+		else if (std::string(argv[i]) == "-baseline") baselineDirectory = argv[i + 1];
+		else if (std::string(argv[i]) == "-bks") pathBKS = argv[i + 1];
+		else if (std::string(argv[i]) == "-csv") pathCSV = argv[i + 1];
+		else { displayHelp(); return 1; }
+	}
+	if (timeBudget <= 0.) { displayHelp(); return 1; }
+
+	try
+	{
+		// Runs of each build (the current one first)
+		std::vector <std::string> builds = { "current" };
+		std::vector < std::vector <BenchmarkRun> > runs = { readRuns(resultDirectory) };
+		if (!baselineDirectory.empty())
+		{
+			builds.push_back("baseline");
+			runs.push_back(readRuns(baselineDirectory));
+		}
+
+		// Reference cost of each instance: given file, then instance file, then best cost found by the runs of all builds
+		std::map <std::string, double> references;
+		if (!pathBKS.empty())
+		{
+			std::ifstream file(pathBKS);
+			if (!file.is_open()) throw std::string("Impossible to open reference costs file: " + pathBKS);
+			std::string instance;
+			double cost;
+			while (file >> instance >> cost) references[instance] = cost;
+		}
+		int nbInstanceReferences = 0;
+		std::map <std::string, double> bestRuns;
+		for (const std::vector <BenchmarkRun> & buildRuns : runs)
+			for (const BenchmarkRun & run : buildRuns)
+			{
+				double cost = costAt(run, timeBudget);
+				if (cost >= 0. && (bestRuns.count(run.instance) == 0 || cost < bestRuns[run.instance])) bestRuns[run.instance] = cost;
+				if (references.count(run.instance) == 0)
+				{
+					double bks = readInstanceBKS(run.path);
+					if (bks > 0.) { references[run.instance] = bks; nbInstanceReferences++; }
+				}
+			}
+		int nbRunReferences = 0;
+		for (const std::pair <const std::string, double> & best : bestRuns)
+			if (references.count(best.first) == 0) { references[best.first] = best.second; nbRunReferences++; }
+
+		std::ofstream csvFile;
+		if (!pathCSV.empty())
+		{
+			csvFile.open(pathCSV);
+			if (!csvFile.is_open()) throw std::string("Impossible to write benchmark CSV file: " + pathCSV);
+			csvFile << "build;set;instance;seed;reference;finalCost;finalGap;primalIntegral";
+			for (double fraction : curveFractions) csvFile << ";gap" << 100. * fraction;
+			csvFile << std::endl;
+		}
+
+		// Indicators of each set and build, and mean primal integral of each instance and build
+		std::vector < std::map <std::string, GroupIndicators> > sets(builds.size());
+		std::vector < std::map <std::string, GroupIndicators> > instances(builds.size());
+		for (int b = 0; b < (int)builds.size(); b++)
+			for (const BenchmarkRun & run : runs[b])
+			{
+				if (references.count(run.instance) == 0) continue; // No run of the instance found a solution within the time budget
+				RunIndicators indicators = computeIndicators(run, references[run.instance], timeBudget);
+				sets[b][instanceSet(run.instance)].add(indicators);
+				sets[b]["ALL"].add(indicators);
+				instances[b][run.instance].add(indicators);
+				if (csvFile.is_open())
+				{
+					csvFile << builds[b] << ";" << instanceSet(run.instance) << ";" << run.instance << ";" << run.seed << ";" << references[run.instance] << ";"
+						<< indicators.finalCost << ";" << indicators.finalGap << ";" << indicators.primalIntegral;
+					for (double value : indicators.curve) csvFile << ";" << value;
+					csvFile << std::endl;
+				}
+			}
+
+		std::cout << "----- BENCHMARK REPORT | TIME BUDGET " << timeBudget << " s | " << sets[0]["ALL"].nbRuns << " RUNS ON " << instances[0].size() << " INSTANCES" << std::endl;
+		std::cout << "----- REFERENCE COSTS: " << references.size() - nbInstanceReferences - nbRunReferences << " FROM FILE | "
+			<< nbInstanceReferences << " FROM INSTANCE FILES | " << nbRunReferences << " BEST COSTS OF THE RUNS" << std::endl;
+		std::cout << "----- AVERAGES OVER THE RUNS (PRIMAL GAP OF 100% WHILE NO SOLUTION IS FOUND)" << std::endl;
+		printHeader();
+		std::vector <std::string> setNames;
+		for (const std::pair <const std::string, GroupIndicators> & set : sets[0]) if (set.first != "ALL") setNames.push_back(set.first);
+		if (builds.size() > 1)
+			for (const std::pair <const std::string, GroupIndicators> & set : sets[1])
+				if (set.first != "ALL" && sets[0].count(set.first) == 0) setNames.push_back(set.first);
+		setNames.push_back("ALL");
+		for (const std::string & set : setNames)
+		{
+			for (int b = 0; b < (int)builds.size(); b++) printIndicators(set, builds[b], sets[b][set], true);
+			if (builds.size() < 2) continue;
+
+			// Difference of the averages (current minus baseline: negative values are improvements)
+			GroupIndicators & current = sets[0][set];
+			GroupIndicators & baseline = sets[1][set];
+			if (current.nbRuns == 0 || baseline.nbRuns == 0) continue;
+			GroupIndicators difference;
+			difference.finalGap = current.finalGap / current.nbRuns - baseline.finalGap / baseline.nbRuns;
+			difference.primalIntegral = current.primalIntegral / current.nbRuns - baseline.primalIntegral / baseline.nbRuns;
+			for (int i = 0; i < (int)difference.curve.size(); i++) difference.curve[i] = current.curve[i] / current.nbRuns - baseline.curve[i] / baseline.nbRuns;
+			printIndicators(set, "diff", difference, false);
+
+			// Instances on which the mean primal integral of the current build is lower (or higher) than the one of the baseline
+			int nbImproved = 0, nbDegraded = 0, nbEqual = 0;
+			for (const std::pair <const std::string, GroupIndicators> & instance : instances[0])
+			{
+				if ((set != "ALL" && instanceSet(instance.first) != set) || instances[1].count(instance.first) == 0) continue;
+				const GroupIndicators & other = instances[1][instance.first];
+				double delta = instance.second.primalIntegral / instance.second.nbRuns - other.primalIntegral / other.nbRuns;
+				if (delta < -1.e-6) nbImproved++;
+				else if (delta > 1.e-6) nbDegraded++;
+				else nbEqual++;
+			}
+			std::cout << std::left << std::setw(8) << set << std::right << "INSTANCES IMPROVED " << nbImproved << " | DEGRADED " << nbDegraded << " | EQUAL " << nbEqual
+				<< " (MEAN PRIMAL INTEGRAL)" << std::endl;
+		}
+	}
+	catch (const std::string & e) { std::cout << "EXCEPTION | " << e << std::endl; return 1; }
+	catch (const std::exception & e) { std::cout << "EXCEPTION | " << e.what() << std::endl; return 1; }
+	return 0;
+}
@@ -36,21 +36,37 @@ public:
 	int nbVeh		 = INT_MAX;		// Number of vehicles. Default value: infinity
 	std::string pathInstance;		// Instance path
 	std::string pathSolution;		// Solution path
+	std::string pathBatch;			// Path of the list of jobs solved in batch mode (replaces the instance and solution paths)
+	int batchThreads = 0;			// Number of jobs solved in parallel in batch mode. Default value: number of hardware threads
+	std::string pathInitialSolution;	// Path of an initial solution in CVRPLib format (optional)
+	std::string pathCheckpoint;		// Path of the checkpoint file written periodically during the search (optional)
+	double checkpointInterval = 60.;	// Minimum time in seconds between two checkpoints
+	std::string pathResume;			// Path of a checkpoint file from which the search is resumed (optional)
+	std::string pathTelemetry;		// Path of the telemetry file (JSON lines) written during the search (optional)
+	double telemetryInterval = 1.;	// Time in seconds between two state records of the telemetry
+	std::string pathTrace;			// Path of the trace file (Chrome trace format) of the phases of the search (optional)
+	std::string pathLocalSearchStats;	// Path of the CSV file receiving the counters of the local search operators (optional, requires the HGS_LS_STATS build option)
 	bool verbose     = true;
 	bool isRoundingInteger = true;
+	bool useCache    = false;		// Reads the preprocessed instance from its cache file (<instance>.hgscache), or writes this file
 
 	// Reads the line of command and extracts possible options
 	CommandLine(int argc, char* argv[])
 	{
-		if (argc % 2 != 1 || argc > 37 || argc < 3)
+		if (argc % 2 != 1 || argc > 77 || argc < 3)
 		{
 			std::cout << "----- NUMBER OF COMMANDLINE ARGUMENTS IS INCORRECT: " << argc << std::endl;
 			display_help(); throw std::string("Incorrect line of command");
 		}
 		else
 		{
-			pathInstance = std::string(argv[1]);
-			pathSolution = std::string(argv[2]);
+			if (std::string(argv[1]) == "-batch")
+				pathBatch = std::string(argv[2]);
+			else
+			{
+				pathInstance = std::string(argv[1]);
+				pathSolution = std::string(argv[2]);
+			}
 			for (int i = 3; i < argc; i += 2)
 			{
 				if (std::string(argv[i]) == "-t")
@@ -65,6 +81,32 @@ public:
 					isRoundingInteger = atoi(argv[i+1]);
 				else if (std::string(argv[i]) == "-log")
 					verbose = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-cache")
+					useCache = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-init")
+					pathInitialSolution = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-checkpoint")
+					pathCheckpoint = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-checkpointInterval")
+					checkpointInterval = atof(argv[i+1]);
+				else if (std::string(argv[i]) == "-resume")
+					pathResume = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-telemetry")
+					pathTelemetry = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-telemetryInterval")
+					telemetryInterval = atof(argv[i+1]);
+				else if (std::string(argv[i]) == "-batchThreads")
+					batchThreads = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-trace")
+					pathTrace = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-lsStats")
+					pathLocalSearchStats = std::string(argv[i+1]);
+				else if (std::string(argv[i]) == "-nbThreads")
+					ap.nbThreads = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-crossoverType")
+					ap.crossoverType = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-lsCacheSize")
+					ap.lsCacheSize = atoi(argv[i+1]);
 				else if (std::string(argv[i]) == "-nbGranular")
 					ap.nbGranular = atoi(argv[i+1]);
 				else if (std::string(argv[i]) == "-mu")
@@ -77,6 +119,10 @@ public:
 					ap.nbClose = atoi(argv[i+1]);
 				else if (std::string(argv[i]) == "-targetFeasible")
 					ap.targetFeasible = atof(argv[i+1]);
+				else if (std::string(argv[i]) == "-packedDistances")
+					ap.packedDistances = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-spatialOrdering")
+					ap.spatialOrdering = atoi(argv[i+1]);
 				else if (std::string(argv[i]) == "-randGen")
 					ap.randGeneration = atof(argv[i+1]);
 				else if (std::string(argv[i]) == "-mdmNbElite")
@@ -87,12 +133,27 @@ public:
 					ap.mdmNURestarts = atof(argv[i+1]);
 				else if (std::string(argv[i]) == "-mdmMinSup")
 					ap.mdmMinSup = atof(argv[i+1]);
+				else if (std::string(argv[i]) == "-mdmBackgroundMining")
+					ap.mdmBackgroundMining = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-decompositionMinClients")
+					ap.decompositionMinClients = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-decompositionInterval")
+					ap.decompositionInterval = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-decompositionSize")
+					ap.decompositionSize = atoi(argv[i+1]);
+				else if (std::string(argv[i]) == "-decompositionNbIter")
+					ap.decompositionNbIter = atoi(argv[i+1]);
 				else
 				{
 					std::cout << "----- ARGUMENT NOT RECOGNIZED: " << std::string(argv[i]) << std::endl;
 					display_help(); throw std::string("Incorrect line of command");
 				}
 			}
+			if (!pathResume.empty() && !pathInitialSolution.empty())
+			{
+				std::cout << "----- OPTIONS -resume AND -init CANNOT BE COMBINED (THE CHECKPOINT ALREADY HOLDS THE POPULATION)" << std::endl;
+				display_help(); throw std::string("Incorrect line of command");
+			}
 		}
 	}
 
@@ -101,13 +162,24 @@ public:
 	{
 		std::cout << std::endl;
 		std::cout << "-------------------------------------------------- HGS-CVRP algorithm (2020) ---------------------------------------------------" << std::endl;
-		std::cout << "Call with: ./hgs instancePath solPath [-it nbIter] [-t myCPUtime] [-seed mySeed] [-veh nbVehicles] [-log verbose]               " << std::endl;
+		std::cout << "Call with: ./hgs instancePath solPath [-it nbIter] [-t myWallTime] [-seed mySeed] [-veh nbVehicles] [-log verbose]              " << std::endl;
 		std::cout << "[-it <int>] sets a maximum number of iterations without improvement. Defaults to 20,000                                         " << std::endl;
-		std::cout << "[-t <double>] sets a time limit in seconds. If this parameter is set the code will be run iteratively until the time limit      " << std::endl;
+		std::cout << "[-t <double>] sets a wall-clock time limit in seconds. If this parameter is set the code will be run iteratively until the limit" << std::endl;
 		std::cout << "[-seed <int>] sets a fixed seed. Defaults to 0                                                                                  " << std::endl;
 		std::cout << "[-veh <int>] sets a prescribed fleet size. Otherwise a reasonable UB on the the fleet size is calculated                        " << std::endl;
 		std::cout << "[-round <bool>] rounding the distance to the nearest integer or not. It can be 0 (not rounding) or 1 (rounding). Defaults to 1. " << std::endl;
 		std::cout << "[-log <bool>] sets the verbose level of the algorithm log. It can be 0 or 1. Defaults to 1.                                     " << std::endl;
+		std::cout << "[-cache <bool>] reuses the preprocessed instance from <instance>.hgscache, written when missing or outdated. Defaults to 0      " << std::endl;
+		std::cout << "[-init <string>] initial solution in CVRPLib format, improved by local search and inserted in the population and MDM elite set  " << std::endl;
+		std::cout << "[-checkpoint <string>] path of a binary checkpoint of the search state, written periodically during the search                  " << std::endl;
+		std::cout << "[-checkpointInterval <double>] minimum time in seconds between two checkpoints. Defaults to 60                                  " << std::endl;
+		std::cout << "[-resume <string>] resumes the search from a checkpoint (same instance, options and number of threads)                          " << std::endl;
+		std::cout << "[-telemetry <string>] writes JSON lines with the state of the search, restarts and pattern mining events                        " << std::endl;
+		std::cout << "[-telemetryInterval <double>] time in seconds between two state records of the telemetry. Defaults to 1                         " << std::endl;
+		std::cout << "[-batch <string>] (instead of instancePath solPath) solves the jobs listed in a file: instancePath solPath [seed] [timeLimit]   " << std::endl;
+		std::cout << "[-batchThreads <int>] number of jobs of a batch solved in parallel. Defaults to the number of hardware threads                  " << std::endl;
+		std::cout << "[-trace <string>] writes the spans of the main phases of the search in Chrome trace format (chrome://tracing, Perfetto)         " << std::endl;
+		std::cout << "[-lsStats <string>] writes the counters of the local search operators in a CSV file (builds with -DHGS_LS_STATS=ON)             " << std::endl;
 		std::cout << std::endl;
 		std::cout << "Additional Arguments:                                                                                                           " << std::endl;
 		std::cout << "[-nbGranular <int>] Granular search parameter, limits the number of moves in the RI local search. Defaults to 20                " << std::endl;
@@ -121,6 +193,16 @@ public:
 		std::cout << "[-mdmNbPatterns <int>] Number of (largest) patterns mined from the MDM elite set. Defaults to 5                                 " << std::endl;
 		std::cout << "[-mdmNURestarts <double>] Maximum percentage of restarts without updating the MDM elite set. Defaults to 0.05                   " << std::endl;
 		std::cout << "[-mdmMinSup <double>] Minimum support of patterns mined from the MDM elite set. Defaults to 0.8                                 " << std::endl;
+		std::cout << "[-spatialOrdering <int>] Renumbers the clients along a space-filling curve: 0 (none), 1 (Morton), 2 (Hilbert). Defaults to 0    " << std::endl;
+		std::cout << "[-nbThreads <int>] Number of offspring generated per iteration and improved by parallel local search threads. Defaults to 1     " << std::endl;
+		std::cout << "[-mdmBackgroundMining <int>] If set to 1, MDM patterns are mined in a background thread (non-reproducible runs). Defaults to 0  " << std::endl;
+		std::cout << "[-packedDistances <int>] Packed storage of symmetric distances: 0 (never), 1 (always), -1 (5,000 nodes or more). Defaults to -1 " << std::endl;
+		std::cout << "[-lsCacheSize <int>] Number of local search results memorized, to avoid improving a solution twice. Defaults to 0 (inactive)    " << std::endl;
+		std::cout << "[-crossoverType <int>] Crossover operator: 0 (OX completed by Split), 1 (SREX, route exchange without Split). Defaults to 0     " << std::endl;
+		std::cout << "[-decompositionMinClients <int>] Decomposes the search on instances with this number of clients or more. Defaults to 2000       " << std::endl;
+		std::cout << "[-decompositionInterval <int>] Number of iterations between two decomposition phases. Defaults to 1000                          " << std::endl;
+		std::cout << "[-decompositionSize <int>] Target number of clients of a subproblem of the decomposition. Defaults to 200                       " << std::endl;
+		std::cout << "[-decompositionNbIter <int>] Iterations without improvement of the search on a subproblem. Defaults to 1000                     " << std::endl;
 		std::cout << "--------------------------------------------------------------------------------------------------------------------------------" << std::endl;
 		std::cout << std::endl;
 	};
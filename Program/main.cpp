@@ -3,8 +3,138 @@
 #include "LocalSearch.h"
 #include "Split.h"
 #include "InstanceCVRPLIB.h"
+#include <atomic>
 using namespace std;
 
+// Sets the parameters whose default value depends on the size of the instance
+static void setDynamicDefaults(Params & params)
+{
+	if (params.ap.randGeneration < 0)
+		if (params.nbClients < 200)
+			params.ap.randGeneration = 0.1;
+		else if (params.nbClients < 400)
+			params.ap.randGeneration = 0.8;
+		else
+			params.ap.randGeneration = 0.2;
+	if (params.ap.mdmNbElite < 0)
+		if (params.nbClients < 200)
+			params.ap.mdmNbElite = 5;
+		else if (params.nbClients < 400)
+			params.ap.mdmNbElite = 10;
+		else if (params.nbClients < 1001)
+			params.ap.mdmNbElite = 5;
+		else
+			params.ap.mdmNbElite = 0;
+}
+
+// Job of a batch: one search on an instance, with its own seed and time limit
+struct BatchJob
+{
+	std::string pathSolution;	// Solution path
+	int seed;					// Random seed
+	double timeLimit;			// Time limit in seconds (0 for none)
+	int instance;				// Index of the instance in the batch
+};
+
+// Instance of a batch, loaded and preprocessed once (by the first job which needs it) and shared by all its jobs
+struct BatchInstance
+{
+	std::string path;							// Instance path
+	std::once_flag isLoaded;					// Set once the instance has been loaded (or has failed to load)
+	std::shared_ptr <const InstanceCache> cache;	// Preprocessed instance, released once all jobs of the instance are completed
+	std::string error;							// Error raised while loading the instance (if any)
+	std::atomic <int> nbRemainingJobs;			// Number of jobs of the instance not yet completed
+	BatchInstance(std::string path) : path(path), nbRemainingJobs(0) {}
+};
+
+// Solves the jobs listed in a file (one job per line: instancePath solutionPath [seed] [timeLimit]) on a pool of threads
+// The seed and time limit default to the ones of the line of command. Empty lines and lines starting with # are ignored
+static void runBatch(const CommandLine & commandline)
+{
+	std::ifstream listFile(commandline.pathBatch);
+	if (!listFile.is_open()) throw std::string("Impossible to open batch file: " + commandline.pathBatch);
+	std::vector <BatchJob> jobs;
+	std::vector < std::unique_ptr <BatchInstance> > instances;
+	std::string line;
+	while (std::getline(listFile, line))
+	{
+		std::istringstream lineStream(line);
+		std::string pathInstance;
+		BatchJob job;
+		if (!(lineStream >> pathInstance) || pathInstance[0] == '#') continue;
+		if (!(lineStream >> job.pathSolution)) throw std::string("Incorrect line in batch file: " + line);
+		if (!(lineStream >> job.seed)) job.seed = commandline.ap.seed;
+		if (!(lineStream >> job.timeLimit)) job.timeLimit = commandline.ap.timeLimit;
+		job.instance = 0;
+		while (job.instance < (int)instances.size() && instances[job.instance]->path != pathInstance) job.instance++;
+		if (job.instance == (int)instances.size()) instances.emplace_back(new BatchInstance(pathInstance));
+		instances[job.instance]->nbRemainingJobs++;
+		jobs.push_back(job);
+	}
+
+	// The jobs of a same instance are run consecutively, so that few preprocessed instances are kept in memory at the same time
+	std::stable_sort(jobs.begin(), jobs.end(), [](const BatchJob & a, const BatchJob & b) { return a.instance < b.instance; });
+
+	int nbThreads = (commandline.batchThreads > 0) ? commandline.batchThreads : std::max<int>(1, (int)std::thread::hardware_concurrency());
+	nbThreads = std::min<int>(nbThreads, (int)jobs.size());
+	if (commandline.verbose) std::cout << "----- SOLVING " << jobs.size() << " JOBS ON " << instances.size() << " INSTANCES WITH " << nbThreads << " THREADS" << std::endl;
+
+	std::atomic <int> nextJob(0);
+	std::mutex outputMutex;
+	auto solveJobs = [&]()
+	{
+		for (int j = nextJob++; j < (int)jobs.size(); j = nextJob++)
+		{
+			const BatchJob & job = jobs[j];
+			BatchInstance & instance = *instances[job.instance];
+			std::string result;
+			try
+			{
+				std::call_once(instance.isLoaded, [&]()
+				{
+					try
+					{
+						InstanceCVRPLIB cvrp(instance.path, commandline.isRoundingInteger, commandline.ap);
+						Params params(cvrp.x_coords,cvrp.y_coords,std::move(cvrp.dist_mtx),cvrp.service_time,cvrp.demands,
+							cvrp.vehicleCapacity,cvrp.durationLimit,commandline.nbVeh,cvrp.isDurationConstraint,false,commandline.ap);
+						instance.cache = std::make_shared<const InstanceCache>(cvrp, commandline.isRoundingInteger, params);
+					}
+					catch (const std::string & e) { instance.error = e; }
+				});
+				if (!instance.error.empty()) throw instance.error;
+
+				AlgorithmParameters ap = commandline.ap;
+				ap.seed = job.seed;
+				ap.timeLimit = job.timeLimit;
+				Params params(instance.cache, commandline.nbVeh, false, ap);
+				setDynamicDefaults(params);
+				Genetic solver(params);
+				solver.run();
+				if (solver.population.getBestFound() != NULL)
+				{
+					solver.population.exportCVRPLibFormat(*solver.population.getBestFound(), job.pathSolution);
+					solver.population.exportSearchProgress(job.pathSolution + ".PG.csv", instance.path);
+					std::ostringstream message;
+					message << "COST " << solver.population.getBestFound()->eval.penalizedCost << " | T(s) " << params.getElapsedTime();
+					result = message.str();
+				}
+				else result = "NO SOLUTION";
+			}
+			catch (const std::string & e) { result = "EXCEPTION | " + e; }
+			catch (const std::exception & e) { result = "EXCEPTION | " + std::string(e.what()); }
+			if (--instance.nbRemainingJobs == 0) instance.cache.reset();
+
+			std::lock_guard <std::mutex> lock(outputMutex);
+			std::cout << "----- JOB " << j + 1 << "/" << jobs.size() << " | " << instance.path << " | SEED " << job.seed << " | " << result << std::endl;
+		}
+	};
+
+	std::vector <std::thread> threads;
+	for (int t = 1; t < nbThreads; t++) threads.emplace_back(solveJobs);
+	solveJobs();
+	for (std::thread & thread : threads) thread.join();
+}
+
 int main(int argc, char *argv[])
 {
 	try
@@ -12,36 +142,60 @@ int main(int argc, char *argv[])
 		// Reading the arguments of the program
 		CommandLine commandline(argc, argv);
 
-		// Reading the data file and initializing some data structures
-		if (commandline.verbose) std::cout << "----- READING INSTANCE: " << commandline.pathInstance << std::endl;
-		InstanceCVRPLIB cvrp(commandline.pathInstance, commandline.isRoundingInteger);
+		// Solving the jobs listed in a file (-batch)
+		if (!commandline.pathBatch.empty())
+		{
+			runBatch(commandline);
+			return 0;
+		}
 
-		Params params(cvrp.x_coords,cvrp.y_coords,cvrp.dist_mtx,cvrp.service_time,cvrp.demands,
-			          cvrp.vehicleCapacity,cvrp.durationLimit,commandline.nbVeh,cvrp.isDurationConstraint,commandline.verbose,commandline.ap);
+		// Reading the data file and initializing some data structures
+		// With -cache 1, the preprocessed instance is read from its cache file when it matches the instance and the options
+		std::shared_ptr<const InstanceCache> cache;
+		if (commandline.useCache) cache = std::make_shared<const InstanceCache>(commandline.pathInstance, commandline.isRoundingInteger, commandline.ap);
+		std::unique_ptr<Params> paramsPtr;
+		if (cache && cache->isValid)
+		{
+			if (commandline.verbose) std::cout << "----- READING INSTANCE CACHE: " << commandline.pathInstance << ".hgscache" << std::endl;
+			paramsPtr.reset(new Params(cache, commandline.nbVeh, commandline.verbose, commandline.ap));
+		}
+		else
+		{
+			if (commandline.verbose) std::cout << "----- READING INSTANCE: " << commandline.pathInstance << std::endl;
+			InstanceCVRPLIB cvrp(commandline.pathInstance, commandline.isRoundingInteger, commandline.ap);
+			paramsPtr.reset(new Params(cvrp.x_coords,cvrp.y_coords,std::move(cvrp.dist_mtx),cvrp.service_time,cvrp.demands,
+				cvrp.vehicleCapacity,cvrp.durationLimit,commandline.nbVeh,cvrp.isDurationConstraint,commandline.verbose,commandline.ap));
+			if (commandline.useCache)
+			{
+				if (commandline.verbose) std::cout << "----- WRITING INSTANCE CACHE: " << commandline.pathInstance << ".hgscache" << std::endl;
+				InstanceCache::write(commandline.pathInstance, cvrp, commandline.isRoundingInteger, *paramsPtr);
+			}
+		}
+		Params & params = *paramsPtr;
+		if (!commandline.pathTrace.empty()) params.trace.reset(new Trace(commandline.pathTrace));
 		
 		// Dynamic default parameter values
-		if (params.ap.randGeneration < 0)
-			if (params.nbClients < 200)
-				params.ap.randGeneration = 0.1;
-			else if (params.nbClients < 400)
-				params.ap.randGeneration = 0.8;
-			else
-				params.ap.randGeneration = 0.2;
-		if (params.ap.mdmNbElite < 0)
-			if (params.nbClients < 200)
-				params.ap.mdmNbElite = 5;
-			else if (params.nbClients < 400)
-				params.ap.mdmNbElite = 10;
-			else if (params.nbClients < 1001)
-				params.ap.mdmNbElite = 5;
-			else
-				params.ap.mdmNbElite = 0;
+		setDynamicDefaults(params);
 
 		// Print all algorithm parameter values
 		if (commandline.verbose) print_algorithm_parameters(params.ap);
 
 		// Running HGS
 		Genetic solver(params);
+		solver.checkpointPath = commandline.pathCheckpoint;
+		solver.checkpointInterval = commandline.checkpointInterval;
+		solver.telemetryPath = commandline.pathTelemetry;
+		solver.telemetryInterval = commandline.telemetryInterval;
+		if (!commandline.pathResume.empty())
+		{
+			if (params.verbose) std::cout << "----- RESUMING FROM CHECKPOINT: " << commandline.pathResume << std::endl;
+			solver.readCheckpoint(commandline.pathResume);
+		}
+		else if (!commandline.pathInitialSolution.empty())
+		{
+			if (params.verbose) std::cout << "----- READING INITIAL SOLUTION: " << commandline.pathInitialSolution << std::endl;
+			solver.population.addInitialSolution(Population::readCVRPLibFormat(commandline.pathInitialSolution), true);
+		}
 		solver.run();
 		
 		// Exporting the best solution
@@ -51,6 +205,25 @@ int main(int argc, char *argv[])
 			solver.population.exportCVRPLibFormat(*solver.population.getBestFound(),commandline.pathSolution);
 			solver.population.exportSearchProgress(commandline.pathSolution + ".PG.csv", commandline.pathInstance);
 		}
+
+		// Exporting the counters of the local search operators
+		if (!commandline.pathLocalSearchStats.empty())
+		{
+			LocalSearchStats stats = solver.getLocalSearchStats();
+			if (!stats.isEnabled) std::cout << "----- LOCAL SEARCH COUNTERS NOT AVAILABLE (BUILD WITH -DHGS_LS_STATS=ON)" << std::endl;
+			else
+			{
+				if (params.verbose) std::cout << "----- WRITING LOCAL SEARCH COUNTERS IN : " << commandline.pathLocalSearchStats << std::endl;
+				std::ofstream myfile(commandline.pathLocalSearchStats);
+				if (!myfile.is_open()) throw std::string("Impossible to write local search counters: " + commandline.pathLocalSearchStats);
+				myfile << "operator;evaluations;pruned;improvements;totalGain;sampledEvaluations;sampledCycles" << std::endl;
+				for (int op = 0; op < LS_NB_OPERATORS; op++)
+					myfile << ls_operator_name(op) << ";" << stats.operators[op].nbEvaluations << ";" << stats.operators[op].nbPruned << ";" << stats.operators[op].nbImprovements << ";"
+						<< stats.operators[op].totalGain << ";" << stats.operators[op].nbSampledEvaluations << ";" << stats.operators[op].sampledCycles << std::endl;
+				myfile << std::endl << "routeUpdates;" << stats.nbRouteUpdates << std::endl;
+				myfile << "averageRouteLength;" << (stats.nbRouteUpdates > 0 ? (double)stats.totalRouteLength / (double)stats.nbRouteUpdates : 0.) << std::endl;
+			}
+		}
 	}
 	catch (const string& e) { std::cout << "EXCEPTION | " << e << std::endl; }
 	catch (const std::exception& e) { std::cout << "EXCEPTION | " << e.what() << std::endl; }
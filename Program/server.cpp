@@ -0,0 +1,385 @@
+// Local solver service: reads solve requests on a Unix domain socket (or on the standard input) and solves them on a pool of threads started once
+// See ServerProtocol.h for the format of the messages
+
+#include "C_Interface.h"
+#include "ServerProtocol.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+struct Request;
+
+// Connection with a client (a socket, or the standard input and output)
+struct Connection
+{
+	int inFd;										// Descriptor from which the requests are read
+	int outFd;										// Descriptor on which the responses are written
+	bool isSocket;									// Tells whether the descriptors are a socket, closed with the connection
+	std::mutex writeMutex;
+	std::mutex requestsMutex;
+	std::map < uint32_t, std::weak_ptr <Request> > requests;	// Requests of the connection not yet completed
+
+	// Writes a message. Returns FALSE if the client is gone
+	bool send(uint32_t type, uint32_t requestId, const std::string & payload);
+
+	// Cancels all requests of the connection (when the client is gone)
+	void cancelAll();
+
+	Connection(int inFd, int outFd, bool isSocket) : inFd(inFd), outFd(outFd), isSocket(isSocket) {}
+	~Connection() { if (isSocket) close(inFd); }
+};
+
+// Solve request, kept until its result has been sent
+struct Request
+{
+	std::shared_ptr <Connection> connection;		// Connection on which the request was received
+	uint32_t id;									// Identifier chosen by the client
+	std::string payload;							// Content of the request (HgsSolveRequest followed by the arrays)
+	std::atomic <bool> isCancelled;					// Set by a cancel message, or when the client is gone
+
+	// Removes the request from its connection, then sends its final message (result or error), so that the client can reuse its identifier once the message is received
+	void complete(uint32_t type, const std::string & payload);
+
+	Request(std::shared_ptr <Connection> connection, uint32_t id, std::string payload) : connection(connection), id(id), payload(std::move(payload)), isCancelled(false) {}
+};
+
+// Threads solving the requests, started once and waiting for new requests
+class WorkerPool
+{
+public:
+
+	void submit(std::shared_ptr <Request> request)
+	{
+		{
+			std::lock_guard <std::mutex> lock(queueMutex);
+			queue.push_back(request);
+		}
+		requestAdded.notify_one();
+	}
+
+	// Waits until all submitted requests have been solved
+	void waitIdle()
+	{
+		std::unique_lock <std::mutex> lock(queueMutex);
+		allDone.wait(lock, [&] { return queue.empty() && nbRunning == 0; });
+	}
+
+	WorkerPool(int nbThreads) : nbRunning(0)
+	{
+		for (int i = 0; i < nbThreads; i++) threads.emplace_back(&WorkerPool::workerLoop, this);
+	}
+
+private:
+
+	std::deque < std::shared_ptr <Request> > queue;	// Requests waiting for a thread
+	int nbRunning;									// Number of requests being solved
+	std::vector <std::thread> threads;
+	std::mutex queueMutex;
+	std::condition_variable requestAdded;
+	std::condition_variable allDone;
+
+	void workerLoop();
+};
+
+// Helpers reading and writing a complete buffer. They return FALSE at the end of the stream or on error
+static bool readFully(int fd, void * data, std::size_t size)
+{
+	char * position = static_cast<char *>(data);
+	while (size > 0)
+	{
+		ssize_t nbRead = read(fd, position, size);
+		if (nbRead <= 0) return false;
+		position += nbRead;
+		size -= (std::size_t)nbRead;
+	}
+	return true;
+}
+
+static bool writeFully(int fd, const void * data, std::size_t size)
+{
+	const char * position = static_cast<const char *>(data);
+	while (size > 0)
+	{
+		ssize_t nbWritten = write(fd, position, size);
+		if (nbWritten <= 0) return false;
+		position += nbWritten;
+		size -= (std::size_t)nbWritten;
+	}
+	return true;
+}
+
+bool Connection::send(uint32_t type, uint32_t requestId, const std::string & payload)
+{
+	HgsMessageHeader header;
+	header.type = type;
+	header.request_id = requestId;
+	header.size = payload.size();
+	std::lock_guard <std::mutex> lock(writeMutex);
+	return writeFully(outFd, &header, sizeof(header)) && writeFully(outFd, payload.data(), payload.size());
+}
+
+void Connection::cancelAll()
+{
+	std::lock_guard <std::mutex> lock(requestsMutex);
+	for (auto & request : requests)
+		if (std::shared_ptr <Request> running = request.second.lock()) running->isCancelled = true;
+}
+
+void Request::complete(uint32_t type, const std::string & payload)
+{
+	{
+		std::lock_guard <std::mutex> lock(connection->requestsMutex);
+		connection->requests.erase(id);
+	}
+	connection->send(type, id, payload);
+}
+
+// Payload of a solution message
+static std::string encodeSolution(const Solution & sol)
+{
+	std::string payload;
+	auto append = [&](const void * data, std::size_t size) { payload.append(static_cast<const char *>(data), size); };
+	int32_t nbRoutes = sol.n_routes;
+	append(&sol.cost, sizeof(double));
+	append(&sol.time, sizeof(double));
+	append(&nbRoutes, sizeof(int32_t));
+	for (int r = 0; r < sol.n_routes; r++)
+	{
+		int32_t length = sol.routes[r].length;
+		append(&length, sizeof(int32_t));
+		for (int i = 0; i < length; i++)
+		{
+			int32_t client = sol.routes[r].path[i];
+			append(&client, sizeof(int32_t));
+		}
+	}
+	return payload;
+}
+
+static int onIncumbent(const Solution * sol, void * userData)
+{
+	Request & request = *static_cast<Request *>(userData);
+	if (!request.connection->send(HGS_MSG_INCUMBENT, request.id, encodeSolution(*sol))) request.connection->cancelAll();
+	return 0;
+}
+
+static int onPoll(void * userData)
+{
+	return static_cast<Request *>(userData)->isCancelled ? 1 : 0;
+}
+
+// Solves a request and sends back its result (or an error)
+static void solveRequest(Request & request)
+{
+	if (request.isCancelled) { request.complete(HGS_MSG_ERROR, "Request cancelled"); return; }
+
+	HgsSolveRequest fixed;
+	if (request.payload.size() < sizeof(HgsSolveRequest)) { request.complete(HGS_MSG_ERROR, "Truncated solve request"); return; }
+	std::memcpy(&fixed, request.payload.data(), sizeof(HgsSolveRequest));
+	uint64_t n = (fixed.n > 0) ? (uint64_t)fixed.n : 0;
+	if (n < 2 || n > HGS_MAX_NODES || (fixed.has_matrix && n > HGS_MAX_NODES_MATRIX)) { request.complete(HGS_MSG_ERROR, "Invalid number of nodes"); return; }
+	uint64_t nbValues = 4 * n + (fixed.has_matrix ? n * n : 0);
+	if (request.payload.size() != sizeof(HgsSolveRequest) + nbValues * sizeof(double)) { request.complete(HGS_MSG_ERROR, "Size of the solve request does not match its number of nodes"); return; }
+	if (!fixed.has_matrix && !fixed.has_coordinates) { request.complete(HGS_MSG_ERROR, "Coordinates or distance matrix required"); return; }
+
+	// The arrays are copied, since the payload is not aligned for doubles
+	std::vector <double> values(nbValues);
+	std::memcpy(values.data(), request.payload.data() + sizeof(HgsSolveRequest), nbValues * sizeof(double));
+	double * x = values.data();
+	double * y = x + n;
+	double * serviceTime = y + n;
+	double * demand = serviceTime + n;
+	double * matrix = demand + n;
+
+	SolveOptions options = default_solve_options();
+	if (fixed.stream_incumbents) options.new_best_callback = onIncumbent;
+	options.stop_callback = onPoll;
+	options.user_data = &request;
+	Solution * sol;
+	if (fixed.has_matrix)
+		sol = solve_cvrp_dist_mtx_with_options((int)n, fixed.has_coordinates ? x : nullptr, fixed.has_coordinates ? y : nullptr, matrix, serviceTime, demand,
+			fixed.vehicle_capacity, fixed.duration_limit, fixed.is_duration_constraint, fixed.max_nb_veh, &fixed.ap, &options, 0);
+	else
+		sol = solve_cvrp_with_options((int)n, x, y, serviceTime, demand,
+			fixed.vehicle_capacity, fixed.duration_limit, fixed.is_rounding_integer, fixed.is_duration_constraint, fixed.max_nb_veh, &fixed.ap, &options, 0);
+
+	if (sol == nullptr) { request.complete(HGS_MSG_ERROR, "Out of memory"); return; }
+	if (sol->error_code != HGS_OK) request.complete(HGS_MSG_ERROR, sol->error_message);
+	else request.complete(HGS_MSG_RESULT, encodeSolution(*sol));
+	delete_solution(sol);
+}
+
+void WorkerPool::workerLoop()
+{
+	while (true)
+	{
+		std::shared_ptr <Request> request;
+		{
+			std::unique_lock <std::mutex> lock(queueMutex);
+			requestAdded.wait(lock, [&] { return !queue.empty(); });
+			request = queue.front();
+			queue.pop_front();
+			nbRunning++;
+		}
+		try { solveRequest(*request); }
+		catch (const std::bad_alloc &) { request->complete(HGS_MSG_ERROR, "Out of memory"); }
+		request.reset();
+		{
+			std::lock_guard <std::mutex> lock(queueMutex);
+			nbRunning--;
+		}
+		allDone.notify_all();
+	}
+}
+
+// Size of the payload of the largest valid request: with coordinates only, or with a distance matrix
+static const uint64_t maxPayloadSize = sizeof(HgsSolveRequest) + sizeof(double) * std::max<uint64_t>(4 * (uint64_t)HGS_MAX_NODES,
+	4 * (uint64_t)HGS_MAX_NODES_MATRIX + (uint64_t)HGS_MAX_NODES_MATRIX * HGS_MAX_NODES_MATRIX);
+
+// Reads and drops the given number of bytes. Returns FALSE at the end of the stream or on error
+static bool skipFully(int fd, uint64_t size)
+{
+	char buffer[65536];
+	while (size > 0)
+	{
+		std::size_t chunk = (std::size_t)std::min<uint64_t>(size, sizeof(buffer));
+		if (!readFully(fd, buffer, chunk)) return false;
+		size -= chunk;
+	}
+	return true;
+}
+
+// Reads the messages of a connection until the client closes it
+static void readConnection(std::shared_ptr <Connection> connection, WorkerPool & pool)
+{
+	HgsMessageHeader header;
+	while (readFully(connection->inFd, &header, sizeof(header)))
+	{
+		// A message larger than any valid request is not read: the stream cannot be followed any further, so that the connection is closed
+		if (header.size > maxPayloadSize)
+		{
+			connection->send(HGS_MSG_ERROR, header.request_id, "Message larger than the largest valid request");
+			break;
+		}
+		// A solve request reusing the identifier of a request of the connection not yet completed, or beyond the limit of pending requests, is refused without being read
+		if (header.type == HGS_MSG_SOLVE)
+		{
+			const char * refusal = nullptr;
+			{
+				std::lock_guard <std::mutex> lock(connection->requestsMutex);
+				if (connection->requests.count(header.request_id) != 0) refusal = "Identifier of a request not yet completed";
+				else if (connection->requests.size() >= HGS_MAX_PENDING_REQUESTS) refusal = "Too many requests not yet completed on the connection";
+			}
+			if (refusal != nullptr)
+			{
+				if (!skipFully(connection->inFd, header.size)) break;
+				connection->send(HGS_MSG_ERROR, header.request_id, refusal);
+				continue;
+			}
+		}
+
+		std::string payload;
+		try { payload.resize(header.size); }
+		catch (const std::bad_alloc &)
+		{
+			if (!skipFully(connection->inFd, header.size)) break;
+			connection->send(HGS_MSG_ERROR, header.request_id, "Out of memory");
+			continue;
+		}
+		if (!readFully(connection->inFd, &payload[0], payload.size())) break;
+
+		if (header.type == HGS_MSG_SOLVE)
+		{
+			std::shared_ptr <Request> request = std::make_shared<Request>(connection, header.request_id, std::move(payload));
+			{
+				std::lock_guard <std::mutex> lock(connection->requestsMutex);
+				connection->requests[header.request_id] = request;
+			}
+			pool.submit(request);
+		}
+		else if (header.type == HGS_MSG_CANCEL)
+		{
+			std::lock_guard <std::mutex> lock(connection->requestsMutex);
+			auto it = connection->requests.find(header.request_id);
+			if (it != connection->requests.end())
+				if (std::shared_ptr <Request> request = it->second.lock()) request->isCancelled = true;
+		}
+		else connection->send(HGS_MSG_ERROR, header.request_id, "Unknown message type");
+	}
+}
+
+static void displayHelp()
+{
+	std::cerr << "Call with: ./hgs-server [-socket path] [-threads nbThreads]" << std::endl;
+	std::cerr << "[-socket <string>] path of the Unix domain socket on which the requests are received. Otherwise, the requests are read on the standard input" << std::endl;
+	std::cerr << "[-threads <int>] number of requests solved in parallel. Defaults to the number of hardware threads" << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+	std::string socketPath;
+	int nbThreads = std::max<int>(1, (int)std::thread::hardware_concurrency());
+	for (int i = 1; i < argc; i += 2)
+	{
+		if (i + 1 < argc && std::string(argv[i]) == "-socket") socketPath = argv[i + 1];
+		else if (i + 1 < argc && std::string(argv[i]) == "-threads") nbThreads = std::max<int>(1, atoi(argv[i + 1]));
+		else { displayHelp(); return 1; }
+	}
+
+	// A client closing its connection must not terminate the server
+	std::signal(SIGPIPE, SIG_IGN);
+	WorkerPool pool(nbThreads);
+
+	if (socketPath.empty())
+	{
+		// The responses are written on a duplicate of the standard output, which is redirected to the error output so that the messages of the solver do not corrupt the stream
+		int outFd = dup(STDOUT_FILENO);
+		dup2(STDERR_FILENO, STDOUT_FILENO);
+		readConnection(std::make_shared<Connection>(STDIN_FILENO, outFd, false), pool);
+		pool.waitIdle();
+		std::cout.flush();
+		std::_Exit(0); // The threads of the pool are still waiting for requests
+	}
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (listenFd < 0 || socketPath.size() >= sizeof(address.sun_path)) { std::cerr << "----- IMPOSSIBLE TO CREATE SOCKET: " << socketPath << std::endl; return 1; }
+	std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	unlink(socketPath.c_str());
+	if (bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listenFd, 64) != 0)
+	{
+		std::cerr << "----- IMPOSSIBLE TO LISTEN ON SOCKET: " << socketPath << std::endl;
+		return 1;
+	}
+	std::cerr << "----- LISTENING ON " << socketPath << " WITH " << nbThreads << " THREADS" << std::endl;
+
+	while (true)
+	{
+		int clientFd = accept(listenFd, nullptr, nullptr);
+		if (clientFd < 0) continue;
+		std::thread([clientFd, &pool]()
+		{
+			std::shared_ptr <Connection> connection = std::make_shared<Connection>(clientFd, clientFd, true);
+			readConnection(connection, pool);
+			connection->cancelAll(); // The client is gone: its requests are stopped
+		}).detach();
+	}
+}
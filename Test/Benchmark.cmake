@@ -0,0 +1,62 @@
+
+# Quality-versus-time benchmark: solves the instances of the given sets with the given seeds and time budget,
+# then reports the gap curves and primal integrals (compared with the runs of another build if BASELINE is given)
+# Variables: HGS, REPORT (executables), INSTANCES (directory), OUTPUT (directory), SETS, SEEDS, TIME, THREADS, BASELINE, BKS
+
+# delete artifacts from previous runs, if any
+file(REMOVE_RECURSE ${OUTPUT})
+file(MAKE_DIRECTORY ${OUTPUT})
+
+string(REPLACE "," ";" SETS "${SETS}")
+foreach(set ${SETS})
+    # the X instances use rounded distances, the CMT and Golden instances do not
+    if(set STREQUAL "X")
+        set(pattern "X-*.vrp")
+        set(round 1)
+    elseif(set STREQUAL "CMT")
+        set(pattern "CMT*.vrp")
+        set(round 0)
+    elseif(set STREQUAL "Golden")
+        set(pattern "Golden_*.vrp")
+        set(round 0)
+    else()
+        message(FATAL_ERROR "Unknown benchmark set: ${set} (expected X, CMT or Golden)")
+    endif()
+
+    # list of jobs: each instance of the set with each seed
+    file(GLOB instances ${INSTANCES}/${pattern})
+    list(SORT instances)
+    set(jobs ${OUTPUT}/jobs-${set}.txt)
+    file(WRITE ${jobs} "# instancePath solPath seed timeLimit\n")
+    foreach(instance ${instances})
+        get_filename_component(name ${instance} NAME_WE)
+        foreach(seed RANGE 1 ${SEEDS})
+            file(APPEND ${jobs} "${instance} ${OUTPUT}/${name}-${seed}.sol ${seed} ${TIME}\n")
+        endforeach()
+    endforeach()
+
+    # solve the jobs (each job writes its search progress next to its solution)
+    execute_process(
+            COMMAND ${HGS} -batch ${jobs} -batchThreads ${THREADS} -round ${round}
+            RESULT_VARIABLE result
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Benchmark error: solver exited with ${result} on set ${set}")
+    endif()
+endforeach()
+
+# report of the runs
+set(options -t ${TIME} -csv ${OUTPUT}/summary.csv)
+if(BASELINE)
+    list(APPEND options -baseline ${BASELINE})
+endif()
+if(BKS)
+    list(APPEND options -bks ${BKS})
+endif()
+execute_process(
+        COMMAND ${REPORT} ${OUTPUT} ${options}
+        RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Benchmark error: report exited with ${result}")
+endif()
@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 
 void print_solution(struct Solution * sol) {
 
@@ -30,6 +31,32 @@ void print_solution(struct Solution * sol) {
 		printf("\n");
 	}
 }
+// Callback counting the improvements of the best solution and requesting the termination once the optimal cost is reached
+struct CallbackData
+{
+	int n_calls;
+	double last_cost;
+};
+
+int on_new_best(const struct Solution * sol, void * user_data) {
+	struct CallbackData * data = (struct CallbackData *) user_data;
+	assert(sol->cost < data->last_cost);
+	int n_visits = 0;
+	for (int r = 0; r < sol->n_routes; r ++)
+		n_visits += sol->routes[r].length;
+	assert(n_visits == 9);
+	data->n_calls ++;
+	data->last_cost = sol->cost;
+	return sol->cost <= 29;
+}
+
+// Stop callback requesting the termination after a given number of polls
+int on_poll(void * user_data) {
+	int * n_polls = (int *) user_data;
+	(*n_polls) ++;
+	return *n_polls >= 50;
+}
+
 int main()
 {
 	// Preparing algorithm parameters
@@ -192,6 +219,281 @@ int main()
 
 	////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	printf("-------- test.c #8 (spatial ordering of the clients) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	ap.spatialOrdering = 2;
+	struct Solution *sol8 = solve_cvrp(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, verbose);
+
+	print_solution(sol8);
+
+	// The routes must be expressed in the input numbering of the clients
+	int visits[10] = {0};
+	double cost8 = 0.0;
+	for (int r = 0; r < sol8->n_routes; r ++) {
+		struct SolutionRoute route = sol8->routes[r];
+		tail = 0;
+		for (int k = 0; k < route.length; k ++) {
+			head = route.path[k];
+			visits[head] ++;
+			cost8 += rounded_dist_mtx[tail][head];
+			tail = head;
+		}
+		cost8 += rounded_dist_mtx[tail][0];
+	}
+	for (int i = 1; i < n; i ++)
+		assert(visits[i] == 1);
+	assert(cost8 == sol8->cost);
+	assert(sol8->cost == sol->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #9 (offspring generated by parallel threads) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	ap.nbThreads = 4;
+	struct Solution *sol9 = solve_cvrp(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, verbose);
+
+	print_solution(sol9);
+	assert(sol9->cost == sol->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #10 (warm start from an initial solution) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 0;
+	ap.nbIter = 1;
+	ap.spatialOrdering = 2;
+	struct SolveOptions options = default_solve_options();
+	options.n_initial_routes = sol->n_routes;
+	options.initial_routes = sol->routes;
+	options.seed_mdm_elite = 1;
+	struct Solution *sol10 = solve_cvrp_with_options(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, &options, verbose);
+
+	print_solution(sol10);
+	assert(sol10->cost == sol->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #11 (new best solution callback and early termination) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 30;
+	ap.nbIter = 10000;
+	ap.spatialOrdering = 1;
+	struct CallbackData data = {0, 1.e30};
+	options = default_solve_options();
+	options.new_best_callback = on_new_best;
+	options.user_data = &data;
+	struct Solution *sol11 = solve_cvrp_with_options(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, &options, verbose);
+
+	print_solution(sol11);
+	assert(data.n_calls >= 1);
+	assert(data.last_cost == sol11->cost);
+	assert(sol11->cost == sol->cost);
+	assert(sol11->time < 15);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #12 (packed storage of a symmetric distance matrix) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	ap.seed = 12;
+	ap.packedDistances = 1;
+	struct Solution *sol12 = solve_cvrp_dist_mtx(
+		n, x, y, (double*)rounded_dist_mtx, s, d,
+		v_cap, duration_limit, isDurationConstraint,
+		max_nbVeh, &ap, verbose);
+
+	print_solution(sol12);
+	assert(sol12->cost == sol7->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #13 (memorized local search results) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	ap.lsCacheSize = 1000;
+	struct Solution *sol13 = solve_cvrp(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, verbose);
+
+	print_solution(sol13);
+	assert(sol13->cost == sol->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #14 (SREX crossover) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	ap.crossoverType = 1;
+	struct Solution *sol14 = solve_cvrp(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, verbose);
+
+	print_solution(sol14);
+	assert(sol14->cost == sol->cost);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #15 (counters of the local search operators) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 1.73;
+	ap.nbIter = 10000;
+	struct LocalSearchStats stats;
+	options = default_solve_options();
+	options.ls_stats = &stats;
+	struct Solution *sol15 = solve_cvrp_with_options(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, &options, verbose);
+
+	print_solution(sol15);
+	assert(sol15->cost == sol->cost);
+	for (int op = 0; op < LS_NB_OPERATORS; op++)
+	{
+		if (stats.isEnabled) printf("%s: %llu evaluations, %llu improvements\n", ls_operator_name(op), (unsigned long long)stats.operators[op].nbEvaluations, (unsigned long long)stats.operators[op].nbImprovements);
+		assert(stats.operators[op].nbPruned <= stats.operators[op].nbEvaluations);
+		assert(stats.operators[op].nbImprovements <= stats.operators[op].nbEvaluations);
+		assert(stats.operators[op].totalGain >= 0);
+	}
+	assert(!stats.isEnabled || (stats.operators[LS_MOVE1].nbEvaluations > 0 && stats.nbRouteUpdates > 0));
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #16 (stop callback) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.timeLimit = 30;
+	ap.nbIter = 10000;
+	int n_polls = 0;
+	options = default_solve_options();
+	options.stop_callback = on_poll;
+	options.user_data = &n_polls;
+	struct Solution *sol16 = solve_cvrp_with_options(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		2, &ap, &options, verbose);
+
+	print_solution(sol16);
+	assert(n_polls == 50);
+	assert(sol16->time < 30);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #17 (decomposition in subproblems) -----\n");
+
+	// Larger instance, with the decomposition triggered every 50 iterations on groups of about 30 clients
+	int n17 = 121;
+	double x17[121], y17[121], s17[121], d17[121];
+	for (int i = 0; i < n17; i ++) {
+		x17[i] = (i == 0) ? 50 : (i * 37) % 101;
+		y17[i] = (i == 0) ? 50 : (i * 53) % 97;
+		s17[i] = 0;
+		d17[i] = (i == 0) ? 0 : 1 + i % 5;
+	}
+	ap = default_algorithm_parameters();
+	ap.nbIter = 200;
+	ap.decompositionMinClients = 100;
+	ap.decompositionInterval = 50;
+	ap.decompositionSize = 30;
+	ap.decompositionNbIter = 50;
+	struct Solution *sol17 = solve_cvrp(
+		n17, x17, y17, s17, d17,
+		20, 100000000, isRoundingInteger, 0,
+		INT_MAX, &ap, verbose);
+
+	print_solution(sol17);
+
+	// The reassembled routes must visit each client once and respect the capacity
+	int visits17[121] = {0};
+	for (int r = 0; r < sol17->n_routes; r ++) {
+		struct SolutionRoute route = sol17->routes[r];
+		double load = 0;
+		for (int k = 0; k < route.length; k ++) {
+			visits17[route.path[k]] ++;
+			load += d17[route.path[k]];
+		}
+		assert(load <= 20);
+	}
+	for (int i = 1; i < n17; i ++)
+		assert(visits17[i] == 1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #18 (error codes) -----\n");
+
+	// A single vehicle cannot service the clients: the solve fails with a description of the error instead of a solution
+	ap = default_algorithm_parameters();
+	ap.nbIter = 100;
+	struct Solution *sol18 = solve_cvrp(
+		n, x, y, s, d,
+		v_cap, 100000000, isRoundingInteger, 0,
+		1, &ap, verbose);
+
+	printf("Error %d: %s\n", sol18->error_code, sol18->error_message);
+	assert(sol18->error_code == HGS_ERROR_INVALID_INPUT);
+	assert(sol18->error_message[0] != '\0');
+	assert(sol18->n_routes == 0);
+	assert(sol->error_code == HGS_OK && sol->error_message[0] == '\0');
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	printf("-------- test.c #19 (stop callback during a decomposition phase) -----\n");
+
+	// Without limit on the iterations, the search only ends when the stop callback, also polled by the subproblems, requests it
+	ap = default_algorithm_parameters();
+	ap.nbIter = 1000000000;
+	ap.decompositionMinClients = 100;
+	ap.decompositionInterval = 20;
+	ap.decompositionSize = 30;
+	ap.decompositionNbIter = 1000000000;
+	n_polls = 0;
+	options = default_solve_options();
+	options.stop_callback = on_poll;
+	options.user_data = &n_polls;
+	struct Solution *sol19 = solve_cvrp_with_options(
+		n17, x17, y17, s17, d17,
+		20, 100000000, isRoundingInteger, 0,
+		INT_MAX, &ap, &options, verbose);
+
+	print_solution(sol19);
+	assert(n_polls == 50);
+	int visits19[121] = {0};
+	for (int r = 0; r < sol19->n_routes; r ++)
+		for (int k = 0; k < sol19->routes[r].length; k ++)
+			visits19[sol19->routes[r].path[k]] ++;
+	for (int i = 1; i < n17; i ++)
+		assert(visits19[i] == 1);
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 	delete_solution(sol);
 	delete_solution(sol2);
 	delete_solution(sol3);
@@ -199,6 +501,18 @@ int main()
 	delete_solution(sol5);
 	delete_solution(sol6);
 	delete_solution(sol7);
+	delete_solution(sol8);
+	delete_solution(sol9);
+	delete_solution(sol10);
+	delete_solution(sol11);
+	delete_solution(sol12);
+	delete_solution(sol13);
+	delete_solution(sol14);
+	delete_solution(sol15);
+	delete_solution(sol16);
+	delete_solution(sol17);
+	delete_solution(sol18);
+	delete_solution(sol19);
 
 	return 0;
 }
\ No newline at end of file
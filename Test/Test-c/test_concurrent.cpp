@@ -0,0 +1,129 @@
+//
+// Stress test of the shared library: many solves running at the same time in one process
+//
+
+#include "C_Interface.h"
+#include "AlgorithmParameters.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Log of one solve, which must only receive lines from the thread of the solve
+struct LogData
+{
+	std::thread::id threadId;
+	int n_lines;
+	int n_foreign_lines;
+};
+
+void on_log(const char * line, void * user_data)
+{
+	LogData * data = (LogData *) user_data;
+	if (std::this_thread::get_id() != data->threadId || line[0] == '\0') data->n_foreign_lines ++;
+	data->n_lines ++;
+}
+
+// Result of one solve: cost, error code and routes
+struct SolveResult
+{
+	int seed;
+	double cost;
+	int error_code;
+	std::vector<std::vector<int> > routes;
+};
+
+int main()
+{
+	// Problem Data (same as test.c)
+	int n = 10;
+	double x[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+	double y[] = {5, 4, 3, 2, 1, 9, 8, 7, 6, 5};
+	double s[] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	double d[] = {0, 2, 3, 1, 2, 3, 1, 2, 3, 1};
+
+	printf("-------- test_concurrent #1 (concurrent solves) -----\n");
+
+	// Each thread runs several solves: valid ones with a few different seeds, logged through the callback or silent,
+	// and invalid ones (a single vehicle cannot service the clients)
+	const int nbThreads = 16;
+	const int nbSolvesPerThread = 6;
+	const int nbSeeds = 4;
+	std::vector<std::vector<SolveResult> > results(nbThreads);
+	std::vector<LogData> logs(nbThreads * nbSolvesPerThread);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < nbThreads; t++)
+		threads.emplace_back([&, t]()
+		{
+			for (int k = 0; k < nbSolvesPerThread; k++)
+			{
+				int job = t * nbSolvesPerThread + k;
+				struct AlgorithmParameters ap = default_algorithm_parameters();
+				ap.nbIter = 500;
+				ap.seed = job % nbSeeds;
+				bool isInvalid = (job % 5 == 4);
+				bool isLogged = (job % 2 == 0);
+
+				struct SolveOptions options = default_solve_options();
+				logs[job] = {std::this_thread::get_id(), 0, 0};
+				if (isLogged)
+				{
+					options.log_callback = on_log;
+					options.user_data = &logs[job];
+				}
+				struct Solution * sol = solve_cvrp_with_options(n, x, y, s, d, 10, 100000000, 1, 0, isInvalid ? 1 : 2, &ap, &options, isLogged);
+				assert(sol != nullptr);
+
+				SolveResult result = {ap.seed, sol->cost, sol->error_code, {}};
+				for (int r = 0; r < sol->n_routes; r++)
+					result.routes.emplace_back(sol->routes[r].path, sol->routes[r].path + sol->routes[r].length);
+				if (isInvalid) assert(sol->error_code == HGS_ERROR_INVALID_INPUT && sol->n_routes == 0 && std::string(sol->error_message).size() > 0);
+				else results[t].push_back(result);
+				delete_solution(sol);
+			}
+		});
+	for (std::thread & thread : threads) thread.join();
+
+	// The solves with the same seed find the same routes, whatever the thread and the other solves running meanwhile
+	std::vector<const SolveResult *> reference(nbSeeds, nullptr);
+	int nbSolves = 0;
+	for (int t = 0; t < nbThreads; t++)
+		for (const SolveResult & result : results[t])
+		{
+			assert(result.error_code == HGS_OK);
+			assert(result.cost == 29);
+			if (reference[result.seed] == nullptr) reference[result.seed] = &result;
+			assert(result.routes == reference[result.seed]->routes);
+			nbSolves++;
+		}
+
+	// Each logged solve received its own lines, in its own thread
+	int nbLoggedSolves = 0;
+	for (int job = 0; job < nbThreads * nbSolvesPerThread; job++)
+	{
+		assert(logs[job].n_foreign_lines == 0);
+		if (job % 2 == 0)
+		{
+			assert(logs[job].n_lines > 0);
+			nbLoggedSolves++;
+		}
+	}
+	printf("%d solves completed on %d threads, %d of them logged through the callback\n", nbSolves, nbThreads, nbLoggedSolves);
+
+	printf("-------- test_concurrent #2 (invalid inputs) -----\n");
+
+	struct AlgorithmParameters ap = default_algorithm_parameters();
+	struct Solution * sol = solve_cvrp(1, x, y, s, d, 10, 100000000, 1, 0, 2, &ap, 0);
+	assert(sol->error_code == HGS_ERROR_INVALID_INPUT && sol->n_routes == 0);
+	delete_solution(sol);
+	sol = solve_cvrp(n, x, y, s, d, 10, 100000000, 1, 0, 2, nullptr, 0);
+	assert(sol->error_code == HGS_ERROR_INVALID_INPUT && sol->n_routes == 0);
+	delete_solution(sol);
+	sol = solve_cvrp_dist_mtx(n, x, y, nullptr, s, d, 10, 100000000, 0, 2, &ap, 0);
+	assert(sol->error_code == HGS_ERROR_INVALID_INPUT && sol->n_routes == 0);
+	delete_solution(sol);
+	delete_solution(nullptr);
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+//
+// Test of DistanceMatrix::buildEuclidean: the vectorized and threaded computation must give the same bits as std::sqrt and std::round, in both storage layouts
+//
+
+#include "DistanceMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Number of elements of the matrix that differ (bit by bit) from the scalar computation
+int count_differences(const std::vector<double> & x, const std::vector<double> & y, bool isRoundingInteger, bool isPacked, int nbThreads)
+{
+	DistanceMatrix dist_mtx = DistanceMatrix::buildEuclidean(x, y, isRoundingInteger, isPacked, nbThreads);
+	int n = (int)x.size();
+	int nbDifferences = 0;
+	if (dist_mtx.nbNodes() != n || dist_mtx.isPacked() != isPacked) return n * n;
+	for (int i = 0; i < n; i++)
+		for (int j = 0; j < n; j++)
+		{
+			int low = std::min<int>(i, j);
+			int high = std::max<int>(i, j);
+			double expected = 0.;
+			if (i != j)
+			{
+				expected = std::sqrt((x[low] - x[high]) * (x[low] - x[high]) + (y[low] - y[high]) * (y[low] - y[high]));
+				if (isRoundingInteger) expected = std::round(expected);
+			}
+			double value = dist_mtx[i][j];
+			if (std::memcmp(&expected, &value, sizeof(double)) != 0) nbDifferences++;
+		}
+	return nbDifferences;
+}
+
+int main()
+{
+	printf("-------- test_distance_matrix #1 (ties and large coordinates) -----\n");
+
+	// Distances from the depot ending in .5 (rounded away from zero by std::round), close to the ties, and around or above 2^52
+	std::vector<double> x = {0};
+	std::vector<double> y = {0};
+	std::vector<double> values = {0.5, 1.5, 2.5, 3.5, 1048576.5, 0.49999999999999994, 2.5000000000000004, 4503599627370495.5,
+		4503599627370496., 4503599627370497., 9007199254740993., 1e15 + 0.5, 1e17, 1e154, 1e300};
+	for (double value : values)
+	{
+		x.push_back(value); y.push_back(0);
+		x.push_back(-value); y.push_back(value);
+		x.push_back(value / 3); y.push_back(-value / 7);
+	}
+	for (bool isRoundingInteger : {false, true})
+		for (bool isPacked : {false, true})
+		{
+			int nbDifferences = count_differences(x, y, isRoundingInteger, isPacked, 1);
+			printf("%d nodes, rounding %d, packed %d: %d differences\n", (int)x.size(), (int)isRoundingInteger, (int)isPacked, nbDifferences);
+			if (nbDifferences != 0) return 1;
+		}
+
+	printf("-------- test_distance_matrix #2 (large matrix split over threads) -----\n");
+
+	// Odd number of nodes, so that the last element of the rows is computed out of the vectorized loop
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> coordinate(-1000., 1000.);
+	x.clear(); y.clear();
+	for (int i = 0; i < 3001; i++)
+	{
+		// One node out of three is on a line, at integer or half-integer positions, which produces exact ties between these nodes
+		x.push_back((i % 3 == 0) ? std::round(coordinate(generator)) + (i % 2) * 0.5 : coordinate(generator));
+		y.push_back((i % 3 == 0) ? 0. : coordinate(generator));
+	}
+	for (bool isRoundingInteger : {false, true})
+		for (bool isPacked : {false, true})
+		{
+			int nbDifferences = count_differences(x, y, isRoundingInteger, isPacked, 3);
+			printf("%d nodes, rounding %d, packed %d: %d differences\n", (int)x.size(), (int)isRoundingInteger, (int)isPacked, nbDifferences);
+			if (nbDifferences != 0) return 1;
+		}
+
+	return 0;
+}
@@ -0,0 +1,246 @@
+//
+// Test of hgs-server through its binary protocol: solve, stream of incumbents, cancel, then malformed, duplicate, excess and oversized requests
+//
+
+#include "ServerProtocol.h"
+#include "AlgorithmParameters.h"
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define CHECK(condition) do { if (!(condition)) { printf("CHECK FAILED (line %d): %s\n", __LINE__, #condition); nbFailures++; } } while (0)
+
+static int nbFailures = 0;
+
+// Message received from the server
+struct Message
+{
+	uint32_t type;
+	uint32_t request_id;
+	std::string payload;
+};
+
+static bool readFully(int fd, void * data, std::size_t size)
+{
+	char * position = static_cast<char *>(data);
+	while (size > 0)
+	{
+		ssize_t nbRead = read(fd, position, size);
+		if (nbRead <= 0) return false;
+		position += nbRead;
+		size -= (std::size_t)nbRead;
+	}
+	return true;
+}
+
+static void sendMessage(int fd, uint32_t type, uint32_t requestId, const std::string & payload, uint64_t declaredSize)
+{
+	HgsMessageHeader header;
+	header.type = type;
+	header.request_id = requestId;
+	header.size = declaredSize;
+	if (write(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) return;
+	if (!payload.empty() && write(fd, payload.data(), payload.size()) != (ssize_t)payload.size()) return;
+}
+
+static void sendMessage(int fd, uint32_t type, uint32_t requestId, const std::string & payload)
+{
+	sendMessage(fd, type, requestId, payload, payload.size());
+}
+
+// Reads the next message. Returns FALSE if the server closed the connection
+static bool receiveMessage(int fd, Message & message)
+{
+	HgsMessageHeader header;
+	if (!readFully(fd, &header, sizeof(header))) return false;
+	message.type = header.type;
+	message.request_id = header.request_id;
+	message.payload.assign(header.size, '\0');
+	return readFully(fd, &message.payload[0], header.size);
+}
+
+// Solve request on a set of n points: the depot at the center and the clients on a grid, with unit demands
+static std::string solveRequest(int n, double capacity, int maxNbVehicles, const AlgorithmParameters & ap, bool streamIncumbents)
+{
+	HgsSolveRequest fixed;
+	std::memset(&fixed, 0, sizeof(fixed));
+	fixed.n = n;
+	fixed.max_nb_veh = maxNbVehicles;
+	fixed.vehicle_capacity = capacity;
+	fixed.duration_limit = 1.e30;
+	fixed.is_rounding_integer = 1;
+	fixed.has_coordinates = 1;
+	fixed.stream_incumbents = streamIncumbents;
+	fixed.ap = ap;
+	std::vector<double> values(4 * n, 0.);
+	for (int i = 1; i < n; i++)
+	{
+		values[i] = (i * 37) % 101;
+		values[n + i] = (i * 53) % 97;
+		values[3 * n + i] = 1;
+	}
+	values[0] = 50;
+	values[n] = 50;
+	std::string payload(reinterpret_cast<const char *>(&fixed), sizeof(fixed));
+	payload.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(double));
+	return payload;
+}
+
+// Cost, and number of clients visited, of a solution message
+static void decodeSolution(const std::string & payload, double & cost, int & nbVisits)
+{
+	std::memcpy(&cost, payload.data(), sizeof(double));
+	int32_t nbRoutes;
+	std::memcpy(&nbRoutes, payload.data() + 2 * sizeof(double), sizeof(int32_t));
+	std::size_t position = 2 * sizeof(double) + sizeof(int32_t);
+	nbVisits = 0;
+	for (int r = 0; r < nbRoutes; r++)
+	{
+		int32_t length;
+		std::memcpy(&length, payload.data() + position, sizeof(int32_t));
+		position += (1 + length) * sizeof(int32_t);
+		nbVisits += length;
+	}
+}
+
+static int connectTo(const std::string & socketPath)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	for (int attempt = 0; attempt < 100; attempt++)
+	{
+		int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0) return fd;
+		close(fd);
+		std::this_thread::sleep_for(std::chrono::milliseconds(100)); // The server may not listen yet
+	}
+	return -1;
+}
+
+int main(int argc, char * argv[])
+{
+	if (argc < 2) { printf("Call with: test_server <path of hgs-server>\n"); return 1; }
+	std::string socketPath = "test_server.sock";
+	pid_t server = fork();
+	if (server == 0)
+	{
+		execl(argv[1], argv[1], "-socket", socketPath.c_str(), "-threads", "2", (char *)nullptr);
+		_exit(127);
+	}
+	int fd = connectTo(socketPath);
+	if (fd < 0) { printf("IMPOSSIBLE TO CONNECT TO THE SERVER\n"); kill(server, SIGTERM); return 1; }
+
+	printf("-------- test_server #1 (solve with streamed incumbents) -----\n");
+
+	AlgorithmParameters ap = default_algorithm_parameters();
+	ap.nbIter = 500;
+	sendMessage(fd, HGS_MSG_SOLVE, 1, solveRequest(31, 10, INT_MAX, ap, true));
+	int nbIncumbents = 0;
+	Message message;
+	while (receiveMessage(fd, message) && message.type == HGS_MSG_INCUMBENT) nbIncumbents++;
+	double cost;
+	int nbVisits;
+	CHECK(message.type == HGS_MSG_RESULT && message.request_id == 1);
+	decodeSolution(message.payload, cost, nbVisits);
+	printf("%d incumbents, cost %.0f\n", nbIncumbents, cost);
+	CHECK(nbIncumbents > 0);
+	CHECK(nbVisits == 30);
+
+	printf("-------- test_server #2 (cancel) -----\n");
+
+	// Search limited to 60 seconds, cancelled after its first incumbent: the best solution found so far is returned
+	ap = default_algorithm_parameters();
+	ap.nbIter = 1000000000;
+	ap.timeLimit = 60;
+	auto start = std::chrono::steady_clock::now();
+	sendMessage(fd, HGS_MSG_SOLVE, 2, solveRequest(101, 10, INT_MAX, ap, true));
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_INCUMBENT && message.request_id == 2);
+	sendMessage(fd, HGS_MSG_CANCEL, 2, "");
+	while (receiveMessage(fd, message) && message.type == HGS_MSG_INCUMBENT) {}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	CHECK(message.type == HGS_MSG_RESULT && message.request_id == 2);
+	decodeSolution(message.payload, cost, nbVisits);
+	printf("cancelled after %.2f s, cost %.0f\n", elapsed, cost);
+	CHECK(nbVisits == 100);
+	CHECK(elapsed < 30);
+
+	printf("-------- test_server #3 (malformed requests) -----\n");
+
+	ap = default_algorithm_parameters();
+	ap.nbIter = 100;
+	std::string valid = solveRequest(11, 10, INT_MAX, ap, false);
+	sendMessage(fd, HGS_MSG_SOLVE, 3, valid.substr(0, 10));							// Truncated fixed part
+	sendMessage(fd, HGS_MSG_SOLVE, 4, valid.substr(0, valid.size() - sizeof(double)));	// Arrays shorter than the number of nodes
+	sendMessage(fd, HGS_MSG_SOLVE, 5, solveRequest(11, 5, 1, ap, false));			// A single vehicle cannot service the clients
+	sendMessage(fd, 99, 6, "");														// Unknown type of message
+	int nbErrors = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		CHECK(receiveMessage(fd, message));
+		printf("request %u: %s\n", message.request_id, message.payload.c_str());
+		if (message.type == HGS_MSG_ERROR && message.request_id >= 3 && message.request_id <= 6 && !message.payload.empty()) nbErrors++;
+	}
+	CHECK(nbErrors == 4);
+
+	printf("-------- test_server #4 (identifier of a request not yet completed) -----\n");
+
+	// The second request with the same identifier is refused, and the identifier can be reused as soon as the result of the first one is received
+	ap = default_algorithm_parameters();
+	ap.nbIter = 1000000000;
+	ap.timeLimit = 60;
+	sendMessage(fd, HGS_MSG_SOLVE, 9, solveRequest(11, 10, INT_MAX, ap, false));
+	sendMessage(fd, HGS_MSG_SOLVE, 9, valid);
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_ERROR && message.request_id == 9);
+	printf("request %u: %s\n", message.request_id, message.payload.c_str());
+	sendMessage(fd, HGS_MSG_CANCEL, 9, "");
+	CHECK(receiveMessage(fd, message) && message.request_id == 9); // Result, or error if the request was cancelled before being started
+	sendMessage(fd, HGS_MSG_SOLVE, 9, valid);
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_RESULT && message.request_id == 9);
+
+	printf("-------- test_server #5 (too many pending requests) -----\n");
+
+	// The requests beyond the limit are refused, and the pending ones are all answered once cancelled
+	for (int i = 0; i <= HGS_MAX_PENDING_REQUESTS; i++) sendMessage(fd, HGS_MSG_SOLVE, 100 + i, solveRequest(11, 10, INT_MAX, ap, false));
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_ERROR && message.request_id == 100 + HGS_MAX_PENDING_REQUESTS);
+	printf("request %u: %s\n", message.request_id, message.payload.c_str());
+	for (int i = 0; i < HGS_MAX_PENDING_REQUESTS; i++) sendMessage(fd, HGS_MSG_CANCEL, 100 + i, "");
+	int nbAnswered = 0;
+	for (int i = 0; i < HGS_MAX_PENDING_REQUESTS; i++)
+		if (receiveMessage(fd, message) && message.request_id >= 100 && message.request_id < 100 + HGS_MAX_PENDING_REQUESTS) nbAnswered++;
+	CHECK(nbAnswered == HGS_MAX_PENDING_REQUESTS);
+	sendMessage(fd, HGS_MSG_SOLVE, 9, valid);
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_RESULT && message.request_id == 9);
+
+	printf("-------- test_server #6 (oversized message) -----\n");
+
+	// The server answers with an error and closes the connection, without allocating the declared size
+	sendMessage(fd, HGS_MSG_SOLVE, 7, "", (uint64_t)1 << 39);
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_ERROR && message.request_id == 7);
+	printf("request %u: %s\n", message.request_id, message.payload.c_str());
+	CHECK(!receiveMessage(fd, message));
+	close(fd);
+
+	// The server keeps serving the other connections
+	fd = connectTo(socketPath);
+	CHECK(fd >= 0);
+	sendMessage(fd, HGS_MSG_SOLVE, 8, valid);
+	CHECK(receiveMessage(fd, message) && message.type == HGS_MSG_RESULT && message.request_id == 8);
+	close(fd);
+
+	kill(server, SIGTERM);
+	waitpid(server, nullptr, 0);
+	unlink(socketPath.c_str());
+	printf("%d checks failed\n", nbFailures);
+	return nbFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE batchSolution1.sol batchSolution1.sol.PG.csv batchSolution2.sol batchSolution2.sol.PG.csv batchSolution3.sol batchSolution3.sol.PG.csv)
+
+# list of jobs: two seeds on the first instance, one on the second one
+file(WRITE batchJobs.txt "# instancePath solPath seed timeLimit\n")
+file(APPEND batchJobs.txt "../Instances/CVRP/${INSTANCE1}.vrp batchSolution1.sol 1 3\n")
+file(APPEND batchJobs.txt "../Instances/CVRP/${INSTANCE2}.vrp batchSolution2.sol 1 3\n")
+file(APPEND batchJobs.txt "../Instances/CVRP/${INSTANCE1}.vrp batchSolution3.sol 2 3\n")
+
+# solve the jobs
+execute_process(
+        COMMAND ./hgs -batch batchJobs.txt -batchThreads 2
+        RESULTS_VARIABLE result
+)
+message(${result})
+
+# each job should have written its solution and search progress
+foreach(solution batchSolution1.sol batchSolution2.sol batchSolution3.sol)
+    if(NOT EXISTS ${solution} OR NOT EXISTS ${solution}.PG.csv)
+        message(SEND_ERROR "Batch test error: ${solution} not written")
+    else()
+        file(STRINGS ${solution} content)
+        string(FIND "${content}" "Cost" cost_position)
+        if(${cost_position} EQUAL -1)
+            message(SEND_ERROR "Batch test error: no cost in ${solution}")
+        endif()
+    endif()
+endforeach()
@@ -0,0 +1,36 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE_RECURSE benchmarkCurrent benchmarkBaseline)
+file(REMOVE benchmarkSummary.csv)
+
+# search progress of two builds: on CMT1 (reference 524.61 in the instance file), the current build finds a solution twice as costly after 1 s
+# and the optimal one after 3 s, the baseline only finds the first solution after 2 s. No reference is known for X-n101-k25
+file(WRITE benchmarkCurrent/CMT1-1.sol.PG.csv "../Instances/CVRP/CMT1.vrp;1;1049.22;1\n../Instances/CVRP/CMT1.vrp;1;524.61;3\n")
+file(WRITE benchmarkCurrent/X-n101-k25-1.sol.PG.csv "../Instances/CVRP/X-n101-k25.vrp;1;27600;0.5\n")
+file(WRITE benchmarkBaseline/CMT1-1.sol.PG.csv "../Instances/CVRP/CMT1.vrp;1;1049.22;2\n")
+file(WRITE benchmarkBaseline/X-n101-k25-1.sol.PG.csv "../Instances/CVRP/X-n101-k25.vrp;1;27591;0.5\n")
+
+# report over a time budget of 4 s
+execute_process(
+        COMMAND ./hgs-benchmark benchmarkCurrent -t 4 -baseline benchmarkBaseline -csv benchmarkSummary.csv
+        OUTPUT_VARIABLE report
+        RESULTS_VARIABLE result
+)
+message(${report})
+
+# primal integrals: 1 + 0.5 * 2 for the current build, 2 + 0.5 * 2 for the baseline
+# (the separators of the summary are replaced, since semicolons separate the elements of the CMake lists)
+file(READ benchmarkSummary.csv summary)
+string(REPLACE ";" "," summary "${summary}")
+foreach(expected "current,CMT,CMT1,1,524.61,524.61,0,2," "baseline,CMT,CMT1,1,524.61,1049.22,100,3," "baseline,X,X-n101-k25,1,27591,27591,0,0.5,")
+    string(FIND "${summary}" "${expected}" position)
+    if(${position} EQUAL -1)
+        message(SEND_ERROR "Benchmark test error: ${expected} not in summary")
+    endif()
+endforeach()
+foreach(expected "1 FROM INSTANCE FILES | 1 BEST COSTS OF THE RUNS" "CMT     INSTANCES IMPROVED 1 | DEGRADED 0" "X       INSTANCES IMPROVED 0 | DEGRADED 1")
+    string(FIND "${report}" "${expected}" position)
+    if(${position} EQUAL -1)
+        message(SEND_ERROR "Benchmark test error: ${expected} not in report")
+    endif()
+endforeach()
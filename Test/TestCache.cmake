@@ -0,0 +1,50 @@
+
+# delete artifacts from previous runs, if any (the instance is copied, since its cache is written next to it)
+file(REMOVE cacheInstance.vrp.hgscache cacheReference.sol cacheReference.sol.PG.csv cacheWritten.sol cacheWritten.sol.PG.csv
+        cacheRead.sol cacheRead.sol.PG.csv cacheGranular.sol cacheGranular.sol.PG.csv)
+configure_file(../Instances/CVRP/${INSTANCE}.vrp cacheInstance.vrp COPYONLY)
+
+# run without cache, then with a cache written by the first run and read by the second one
+execute_process(
+        COMMAND ./hgs cacheInstance.vrp cacheReference.sol -seed 1 -it 500
+        OUTPUT_VARIABLE output
+)
+execute_process(
+        COMMAND ./hgs cacheInstance.vrp cacheWritten.sol -seed 1 -it 500 -cache 1
+        OUTPUT_VARIABLE output
+)
+string(FIND "${output}" "WRITING INSTANCE CACHE" position)
+if(${position} EQUAL -1 OR NOT EXISTS cacheInstance.vrp.hgscache)
+    message(SEND_ERROR "Cache test error: cache not written")
+endif()
+execute_process(
+        COMMAND ./hgs cacheInstance.vrp cacheRead.sol -seed 1 -it 500 -cache 1
+        OUTPUT_VARIABLE output
+)
+string(FIND "${output}" "READING INSTANCE CACHE" position)
+if(${position} EQUAL -1)
+    message(SEND_ERROR "Cache test error: cache not read")
+endif()
+
+# the runs should find the same solution
+file(READ cacheReference.sol reference)
+foreach(solution cacheWritten.sol cacheRead.sol)
+    file(READ ${solution} content)
+    if(NOT reference STREQUAL content)
+        message(SEND_ERROR "Cache test error: ${solution} differs from the solution found without cache")
+    endif()
+endforeach()
+
+# the granular neighborhoods are stored in the cache, so that another size of neighborhood invalidates it
+execute_process(
+        COMMAND ./hgs cacheInstance.vrp cacheGranular.sol -seed 1 -it 500 -cache 1 -nbGranular 30
+        OUTPUT_VARIABLE output
+)
+string(FIND "${output}" "READING INSTANCE CACHE" position)
+if(NOT ${position} EQUAL -1)
+    message(SEND_ERROR "Cache test error: cache read with another value of nbGranular")
+endif()
+string(FIND "${output}" "WRITING INSTANCE CACHE" position)
+if(${position} EQUAL -1)
+    message(SEND_ERROR "Cache test error: cache not rewritten with another value of nbGranular")
+endif()
@@ -0,0 +1,75 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE checkpointReference.sol checkpointReference.sol.PG.csv checkpointPartial.sol checkpointPartial.sol.PG.csv
+        checkpointResumed.sol checkpointResumed.sol.PG.csv checkpointDecompositionReference.sol checkpointDecompositionReference.sol.PG.csv
+        checkpointDecompositionPartial.sol checkpointDecompositionPartial.sol.PG.csv checkpointDecompositionResumed.sol
+        checkpointDecompositionResumed.sol.PG.csv checkpointState.bin)
+
+# uninterrupted run
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointReference.sol -seed 1 -it 2000 -log 0
+        RESULTS_VARIABLE result
+)
+message(${result})
+
+# same run, stopped early with a checkpoint written at each iteration, then resumed with the full number of iterations
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointPartial.sol -seed 1 -it 300 -log 0 -checkpoint checkpointState.bin -checkpointInterval 0
+        RESULTS_VARIABLE result
+)
+message(${result})
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointResumed.sol -seed 1 -it 2000 -log 0 -resume checkpointState.bin
+        RESULTS_VARIABLE result
+)
+message(${result})
+
+# the resumed run should find the same solution, through the same improvements (the times differ)
+function(compare_runs reference resumed)
+    file(READ ${reference}.sol reference_solution)
+    file(READ ${resumed}.sol resumed_solution)
+    if(NOT reference_solution STREQUAL resumed_solution)
+        message(SEND_ERROR "Checkpoint test error: ${resumed} did not reproduce the solution of the uninterrupted run")
+    endif()
+    foreach(progress ${reference} ${resumed})
+        file(STRINGS ${progress}.sol.PG.csv lines)
+        set(costs_${progress} "")
+        foreach(line ${lines})
+            string(REGEX REPLACE ";[^;]*$" "" line "${line}")
+            string(APPEND costs_${progress} "${line}\n")
+        endforeach()
+    endforeach()
+    if(NOT costs_${reference} STREQUAL costs_${resumed})
+        message(SEND_ERROR "Checkpoint test error: ${resumed} did not reproduce the search progress of the uninterrupted run")
+    endif()
+endfunction()
+compare_runs(checkpointReference checkpointResumed)
+
+# same test with decomposition phases, whose schedule should carry over the checkpoint
+set(decomposition -decompositionMinClients 50 -decompositionInterval 70 -decompositionSize 40 -decompositionNbIter 100)
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointDecompositionReference.sol -seed 1 -it 500 -log 0 ${decomposition}
+        RESULTS_VARIABLE result
+)
+message(${result})
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointDecompositionPartial.sol -seed 1 -it 50 -log 0 ${decomposition} -checkpoint checkpointState.bin -checkpointInterval 0
+        RESULTS_VARIABLE result
+)
+message(${result})
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointDecompositionResumed.sol -seed 1 -it 500 -log 0 ${decomposition} -resume checkpointState.bin
+        RESULTS_VARIABLE result
+)
+message(${result})
+compare_runs(checkpointDecompositionReference checkpointDecompositionResumed)
+
+# a checkpoint already holds the population, so that an initial solution cannot be given along with it
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp checkpointResumed.sol -resume checkpointState.bin -init checkpointReference.sol
+        OUTPUT_VARIABLE output
+)
+string(FIND "${output}" "CANNOT BE COMBINED" position)
+if(${position} EQUAL -1)
+    message(SEND_ERROR "Checkpoint test error: -resume and -init were accepted together")
+endif()
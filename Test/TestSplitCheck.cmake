@@ -0,0 +1,20 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE splitCheckCMT6.sol splitCheckCMT6.sol.PG.csv splitCheckGolden_1.sol splitCheckGolden_1.sol.PG.csv)
+
+# short runs on instances with duration constraints, each label of the Split being checked by the solver (the run stops at the first wrong label)
+# on CMT6, the fleet is limited to the number of routes of the best known solution, so that the Split with limited fleet is also checked
+foreach(run "CMT6;-veh;6" "Golden_1")
+    list(GET run 0 instance)
+    set(options ${run})
+    list(REMOVE_AT options 0)
+    execute_process(
+            COMMAND ./hgs ../Instances/CVRP/${instance}.vrp splitCheck${instance}.sol -seed 1 -round 0 -it 500 ${options}
+            OUTPUT_VARIABLE output
+    )
+    string(FIND "${output}" "EXCEPTION" position)
+    if(NOT ${position} EQUAL -1 OR NOT EXISTS splitCheck${instance}.sol)
+        string(REGEX MATCH "EXCEPTION[^\n]*" error "${output}")
+        message(SEND_ERROR "Split check error on ${instance}: ${error}")
+    endif()
+endforeach()
@@ -0,0 +1,41 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE telemetrySolution.sol telemetrySolution.sol.PG.csv telemetry.jsonl)
+
+# short run with frequent restarts and a state record at almost each iteration
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp telemetrySolution.sol -seed 1 -it 50 -t 3 -log 0 -telemetry telemetry.jsonl -telemetryInterval 0.0005
+        RESULTS_VARIABLE result
+)
+message(${result})
+
+# each line should be a valid JSON object with a known event, and the statistics of the subpopulations should be numbers or null
+file(STRINGS telemetry.jsonl lines)
+set(nb_state 0)
+set(nb_restart 0)
+foreach(line ${lines})
+    string(JSON event ERROR_VARIABLE error GET "${line}" event)
+    if(error)
+        message(SEND_ERROR "Telemetry test error: invalid JSON line ${line}")
+        continue()
+    endif()
+    if(event STREQUAL "state")
+        math(EXPR nb_state "${nb_state} + 1")
+        foreach(subpop feasible infeasible)
+            foreach(field best average diversity)
+                string(JSON type ERROR_VARIABLE error TYPE "${line}" ${subpop} ${field})
+                if(error OR NOT (type STREQUAL "NUMBER" OR type STREQUAL "NULL"))
+                    message(SEND_ERROR "Telemetry test error: ${subpop}.${field} is not a number in ${line}")
+                endif()
+            endforeach()
+        endforeach()
+    elseif(event STREQUAL "restart")
+        math(EXPR nb_restart "${nb_restart} + 1")
+    elseif(NOT event STREQUAL "mining" AND NOT event STREQUAL "dropped")
+        message(SEND_ERROR "Telemetry test error: unknown event ${event}")
+    endif()
+endforeach()
+message("${nb_state} state records, ${nb_restart} restarts")
+if(nb_state EQUAL 0 OR nb_restart EQUAL 0)
+    message(SEND_ERROR "Telemetry test error: state records or restarts missing")
+endif()
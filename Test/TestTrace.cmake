@@ -0,0 +1,31 @@
+
+# delete artifacts from previous runs, if any
+file(REMOVE traceSolution.sol traceSolution.sol.PG.csv trace.json)
+
+# short run with restarts and pattern mining
+execute_process(
+        COMMAND ./hgs ../Instances/CVRP/${INSTANCE}.vrp traceSolution.sol -seed 1 -it 50 -t 2 -log 0 -trace trace.json
+        RESULTS_VARIABLE result
+)
+message(${result})
+
+# the trace should be a JSON array of events
+file(READ trace.json trace)
+string(JSON nb_events ERROR_VARIABLE error LENGTH "${trace}")
+if(error)
+    message(SEND_ERROR "Trace test error: invalid JSON (${error})")
+    return()
+endif()
+message("${nb_events} events")
+string(JSON phase ERROR_VARIABLE error GET "${trace}" 1 ph)
+if(error OR NOT phase STREQUAL "X")
+    message(SEND_ERROR "Trace test error: the first span is not a complete event")
+endif()
+
+# each phase of the search should have been recorded
+foreach(name generatePopulation restart mineElite rcw Split::generalSplit LocalSearch::run RI SWAP* addIndividual managePenalties)
+    string(FIND "${trace}" "\"name\":\"${name}\",\"ph\":\"X\"" position)
+    if(${position} EQUAL -1)
+        message(SEND_ERROR "Trace test error: no span ${name}")
+    endif()
+endforeach()